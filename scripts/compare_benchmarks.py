@@ -0,0 +1,80 @@
+# SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+# SPDX-License-Identifier: MIT
+
+"""
+Compares the frame benchmark of the "benchmark" environment against a baseline and fails if a
+frame got slower by more than the threshold.
+
+Both arguments are either a JSON file as written by --save or a serial log containing the
+BENCHMARK_JSON line (see benchmarkFrames() in src/benchmark.h). Capture a log with e.g.
+  pio run -e benchmark -t upload -t monitor | tee benchmark.log
+
+Usage: python scripts/compare_benchmarks.py [--threshold PERCENT] [--save FILE] BASELINE CURRENT
+"""
+
+import argparse
+import json
+import sys
+
+JSON_PREFIX = "BENCHMARK_JSON "
+# slower by more than this (percent) fails, timing noise on the device is about 1%
+DEFAULT_THRESHOLD = 5.0
+METRICS = ["micros", "spiBytes", "glyphs", "assetReads", "allocations"]
+
+
+def load(path):
+    with open(path, encoding="utf-8", errors="replace") as f:
+        content = f.read()
+    if content.lstrip().startswith("{"):
+        return json.loads(content)
+    results = [line[line.index(JSON_PREFIX) + len(JSON_PREFIX):]
+               for line in content.splitlines() if JSON_PREFIX in line]
+    if not results:
+        raise ValueError("no %sline in %s" % (JSON_PREFIX, path))
+    # the last run if the log has several
+    return json.loads(results[-1])
+
+
+def change(baseline, current):
+    if baseline == 0:
+        return 0.0 if current == 0 else float("inf")
+    return (current - baseline) * 100.0 / baseline
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare frame benchmark results.")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=DEFAULT_THRESHOLD,
+                        help="maximum frame time increase in percent (default: %(default)s)")
+    parser.add_argument("--save", help="write the current results as JSON, e.g. for a history")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(current, f, indent=2)
+
+    print("%-16s %-12s %12s %12s %9s" % ("widget", "metric", "baseline", "current", "change"))
+    for name, stats in current["widgets"].items():
+        base = baseline["widgets"].get(name)
+        if base is None:
+            print("%-16s (new)" % name)
+            continue
+        for metric in METRICS:
+            print("%-16s %-12s %12d %12d %8.1f%%" % (name, metric, base.get(metric, 0),
+                                                     stats[metric],
+                                                     change(base.get(metric, 0), stats[metric])))
+
+    frame_change = change(baseline["frameMicros"], current["frameMicros"])
+    print("frame: %d us -> %d us (%+.1f%%)" % (baseline["frameMicros"], current["frameMicros"],
+                                               frame_change))
+    if frame_change > args.threshold:
+        print("Frame time increased by more than %.1f%%." % args.threshold)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
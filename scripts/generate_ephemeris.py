@@ -0,0 +1,173 @@
+# SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+# SPDX-License-Identifier: MIT
+
+"""
+Generates src/ephemeris_reference.h, the reference table the astro benchmark compares
+SunMoonCalc against.
+
+- sunrise/sunset: NOAA solar calculator algorithm (upper limb, standard refraction), accurate to
+  about a minute for latitudes outside the polar circles
+- moon age: time since the preceding new moon according to Meeus, Astronomical Algorithms,
+  chapter 49 (without the planetary corrections, accurate to about a minute)
+
+Usage: python scripts/generate_ephemeris.py
+"""
+
+import calendar
+import math
+import os
+
+# name, latitude, longitude
+LOCATIONS = [
+    ("Zurich", 47.3769, 8.5417),
+    ("Ushuaia", -54.8019, -68.3030),
+    ("Sydney", -33.8688, 151.2093),
+    ("Anchorage", 61.2181, -149.9003),
+    ("Singapore", 1.3521, 103.8198),
+]
+FIRST_YEAR = 2018
+# time_t is 32bit on the device
+LAST_YEAR = 2037
+# spread the dates over the year so the table covers all seasons
+DAY_STEP = 73
+
+# TT - UTC, close enough for the years covered
+DELTA_T_DAYS = 70.0 / 86400
+
+OUTPUT = os.path.join(os.path.dirname(__file__), "..", "src", "ephemeris_reference.h")
+
+
+def julian_day(timestamp):
+    return timestamp / 86400.0 + 2440587.5
+
+
+def timestamp_from_julian_day(jd):
+    return (jd - 2440587.5) * 86400.0
+
+
+def sun_declination_and_equation_of_time(timestamp):
+    t = (julian_day(timestamp) - 2451545.0) / 36525
+    l0 = (280.46646 + t * (36000.76983 + t * 0.0003032)) % 360
+    m = 357.52911 + t * (35999.05029 - 0.0001537 * t)
+    e = 0.016708634 - t * (0.000042037 + 0.0000001267 * t)
+    mr = math.radians(m)
+    c = (math.sin(mr) * (1.914602 - t * (0.004817 + 0.000014 * t))
+         + math.sin(2 * mr) * (0.019993 - 0.000101 * t)
+         + math.sin(3 * mr) * 0.000289)
+    omega = math.radians(125.04 - 1934.136 * t)
+    apparent_longitude = math.radians(l0 + c - 0.00569 - 0.00478 * math.sin(omega))
+    mean_obliquity = 23 + (26 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60) / 60
+    obliquity = math.radians(mean_obliquity + 0.00256 * math.cos(omega))
+    declination = math.asin(math.sin(obliquity) * math.sin(apparent_longitude))
+
+    y = math.tan(obliquity / 2) ** 2
+    l0r = math.radians(l0)
+    equation_of_time = 4 * math.degrees(
+        y * math.sin(2 * l0r)
+        - 2 * e * math.sin(mr)
+        + 4 * e * y * math.sin(mr) * math.cos(2 * l0r)
+        - 0.5 * y * y * math.sin(4 * l0r)
+        - 1.25 * e * e * math.sin(2 * mr))
+    return declination, equation_of_time
+
+
+def sun_event(midnight_utc, lat, lon, rising):
+    """UTC timestamp of sunrise/sunset on the day starting at midnight_utc (UTC midnight)."""
+    event = midnight_utc + 12 * 3600 - lon * 240
+    for _ in range(3):
+        declination, equation_of_time = sun_declination_and_equation_of_time(event)
+        latr = math.radians(lat)
+        cos_hour_angle = (math.cos(math.radians(90.833)) / (math.cos(latr) * math.cos(declination))
+                          - math.tan(latr) * math.tan(declination))
+        hour_angle = math.degrees(math.acos(cos_hour_angle))
+        noon_minutes = 720 - 4 * lon - equation_of_time
+        minutes = noon_minutes - 4 * hour_angle if rising else noon_minutes + 4 * hour_angle
+        event = midnight_utc + minutes * 60
+    return event
+
+
+def new_moon(k):
+    """UTC timestamp of the new moon with lunation number k (0 = January 2000)."""
+    t = k / 1236.85
+    jde = (2451550.09766 + 29.530588861 * k + 0.00015437 * t ** 2 - 0.000000150 * t ** 3
+           + 0.00000000073 * t ** 4)
+    e = 1 - 0.002516 * t - 0.0000074 * t ** 2
+    m = math.radians(2.5534 + 29.10535670 * k - 0.0000014 * t ** 2 - 0.00000011 * t ** 3)
+    mp = math.radians(201.5643 + 385.81693528 * k + 0.0107582 * t ** 2 + 0.00001238 * t ** 3
+                      - 0.000000058 * t ** 4)
+    f = math.radians(160.7108 + 390.67050284 * k - 0.0016118 * t ** 2 - 0.00000227 * t ** 3
+                     + 0.000000011 * t ** 4)
+    omega = math.radians(124.7746 - 1.56375588 * k + 0.0020672 * t ** 2 + 0.00000215 * t ** 3)
+    jde += (-0.40720 * math.sin(mp)
+            + 0.17241 * e * math.sin(m)
+            + 0.01608 * math.sin(2 * mp)
+            + 0.01039 * math.sin(2 * f)
+            + 0.00739 * e * math.sin(mp - m)
+            - 0.00514 * e * math.sin(mp + m)
+            + 0.00208 * e * e * math.sin(2 * m)
+            - 0.00111 * math.sin(mp - 2 * f)
+            - 0.00057 * math.sin(mp + 2 * f)
+            + 0.00056 * e * math.sin(2 * mp + m)
+            - 0.00042 * math.sin(3 * mp)
+            + 0.00042 * e * math.sin(m + 2 * f)
+            + 0.00038 * e * math.sin(m - 2 * f)
+            - 0.00024 * e * math.sin(2 * mp - m)
+            - 0.00017 * math.sin(omega)
+            - 0.00007 * math.sin(mp + 2 * m)
+            + 0.00004 * math.sin(2 * mp - 2 * f)
+            + 0.00004 * math.sin(3 * m)
+            + 0.00003 * math.sin(mp + m - 2 * f)
+            + 0.00003 * math.sin(2 * mp + 2 * f)
+            - 0.00003 * math.sin(mp + m + 2 * f)
+            + 0.00003 * math.sin(mp - m + 2 * f)
+            - 0.00002 * math.sin(mp - m - 2 * f)
+            - 0.00002 * math.sin(3 * mp + m)
+            + 0.00002 * math.sin(4 * mp))
+    return timestamp_from_julian_day(jde - DELTA_T_DAYS)
+
+
+def moon_age(timestamp):
+    k = math.floor((julian_day(timestamp) - 2451550.09766) / 29.530588861) + 1
+    while new_moon(k) > timestamp:
+        k -= 1
+    return (timestamp - new_moon(k)) / 86400
+
+
+def main():
+    rows = []
+    for name, lat, lon in LOCATIONS:
+        for year in range(FIRST_YEAR, LAST_YEAR + 1):
+            for day_of_year in range(0, 365, DAY_STEP):
+                midnight = calendar.timegm((year, 1, 1, 0, 0, 0)) + day_of_year * 86400
+                # local solar noon makes the day SunMoonCalc calculates for unambiguous
+                solar_noon = int(midnight + 12 * 3600 - lon * 240)
+                rows.append((name, solar_noon, lat, lon,
+                             round(sun_event(midnight, lat, lon, True)),
+                             round(sun_event(midnight, lat, lon, False)),
+                             moon_age(solar_noon)))
+
+    with open(OUTPUT, "w", newline="\n") as out:
+        out.write("// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com\n")
+        out.write("// SPDX-License-Identifier: MIT\n\n")
+        out.write("// Generated by scripts/generate_ephemeris.py - do not edit.\n\n")
+        out.write("#pragma once\n\n")
+        out.write("typedef struct EphemerisReference {\n")
+        out.write("  // local solar noon (UTC), the timestamp to calculate for\n")
+        out.write("  int32_t timestamp;\n")
+        out.write("  float lat;\n")
+        out.write("  float lon;\n")
+        out.write("  int32_t sunRise;\n")
+        out.write("  int32_t sunSet;\n")
+        out.write("  // days since new moon\n")
+        out.write("  float moonAge;\n")
+        out.write("} EphemerisReference;\n\n")
+        out.write("const EphemerisReference EPHEMERIS_REFERENCE[] = {\n")
+        for name, timestamp, lat, lon, rise, set_, age in rows:
+            out.write("  {%d, %.4f, %.4f, %d, %d, %.4f}, // %s\n"
+                      % (timestamp, lat, lon, rise, set_, age, name))
+        out.write("};\n")
+    print("Wrote %d reference rows to %s" % (len(rows), os.path.normpath(OUTPUT)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,398 @@
+# SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+# SPDX-License-Identifier: MIT
+
+"""
+Packs all files below assets/fs into the single archive data/assets.pak which is what ends up
+on the LittleFS partition. Assets keep their path relative to assets/fs as name, e.g.
+"/moon/m-phase-0.bmp", and are looked up by the FNV-1a hash of that name (see AssetStore.h).
+
+BMPs are converted to RGB565 images (see ImageHeader in GfxUi.h), run-length encoded unless that
+doesn't save anything. Each row is encoded on its own as a sequence of packets. A packet starts
+with a control byte, the upper 2 bits tell the type and the lower 6 bits the pixel count - 1:
+- 00: literal, count RGB565 pixels follow
+- 01: run, one RGB565 pixel follows which repeats count times
+- 10: skip, count black pixels that are not drawn at all
+- 11: blend, count premultiplied RGB565 pixels follow, then count 5bit alpha values (1 - 31) as
+  one byte each
+
+Images with an alpha channel (format RLE565_ALPHA) skip transparent rather than black pixels and
+store opaque pixels as literals/runs and translucent pixels as blend packets. Their alpha is taken
+from the source PNGs of the sets in ALPHA_SOURCES, which were only center-cropped to the BMP size.
+
+Environments built with -D ASSETS_PARTITION get the archive written to $BUILD_DIR/assets.bin
+instead, for the raw "assets" partition (see no_ota_assets.csv) which the firmware maps into its
+address space. Raw RGB565 images in there are pushed to the display straight from flash. Flash it
+with
+  pio run -e <env> -t uploadassets
+
+Layout (little-endian):
+- header: magic "TPAK", uint16 version, uint16 slot count (power of 2), uint32 asset count,
+  uint32 reserved
+- index: slot count x {uint32 name hash, uint32 offset, uint32 size}, an open-addressing hash
+  table with linear probing, unused slots have offset 0
+- data: the assets, each aligned to ALIGNMENT bytes
+
+Icons the firmware references by compile-time hash (WEATHER_ICON() in src/icons.h) are checked to
+exist in the archive, a misspelled name fails the build instead of showing no icon.
+
+Runs as PlatformIO pre-script on every build (see platformio.ini) and only rewrites the archive
+if its content changed. Can also be run manually: python scripts/pack_assets.py
+"""
+
+import csv
+import os
+import re
+import struct
+import zlib
+
+MAGIC = b"TPAK"
+VERSION = 1
+ALIGNMENT = 4
+HEADER_FORMAT = "<4sHHII"
+SLOT_FORMAT = "<III"
+
+IMAGE_MAGIC = 0x4954  # "TI"
+IMAGE_FORMAT_RGB565 = 0
+IMAGE_FORMAT_RLE565 = 1
+IMAGE_FORMAT_RLE565_ALPHA = 2
+IMAGE_HEADER_FORMAT = "<HBBHH"
+
+RLE_LITERAL = 0x00
+RLE_RUN = 0x40
+RLE_SKIP = 0x80
+RLE_BLEND = 0xC0
+RLE_MAX_COUNT = 64
+# shorter black runs are cheaper to draw than to interrupt the pushed pixel span for
+RLE_MIN_SKIP = 8
+# runs shorter than this are stored as literals
+RLE_MIN_RUN = 3
+ALPHA_OPAQUE = 32
+
+# asset directory -> directory below assets/ with the PNG sources of its BMPs
+ALPHA_SOURCES = {"/weather/": "weather"}
+
+# icon sets every WEATHER_ICON(name) in src/icons.h expands to
+ICON_SETS = ["/weather/", "/weather-small/"]
+
+
+def fnv1a(name):
+    h = 0x811C9DC5
+    for b in name.encode("utf-8"):
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def collect_assets(source_dir):
+    assets = []
+    for root, _, files in os.walk(source_dir):
+        for file in sorted(files):
+            path = os.path.join(root, file)
+            name = "/" + os.path.relpath(path, source_dir).replace(os.sep, "/")
+            with open(path, "rb") as f:
+                assets.append((name, f.read()))
+    return sorted(assets)
+
+
+def read_bmp(name, content):
+    """Returns the pixels of a 24bit BMP as rows (top-down) of RGB565 values."""
+    data_offset, = struct.unpack_from("<I", content, 10)
+    width, height = struct.unpack_from("<ii", content, 18)
+    planes, bpp, compression = struct.unpack_from("<HHI", content, 26)
+    if content[:2] != b"BM" or planes != 1 or bpp != 24 or compression != 0 or height <= 0:
+        raise ValueError("%s is not an uncompressed, bottom-up 24bit BMP" % name)
+
+    row_size = (width * 3 + 3) & ~3
+    rows = []
+    for row in range(height - 1, -1, -1):
+        start = data_offset + row * row_size
+        pixels = []
+        for col in range(width):
+            b, g, r = content[start + col * 3:start + col * 3 + 3]
+            # same conversion as GfxUi::pushBmp()
+            pixels.append(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+        rows.append(pixels)
+    return width, height, rows
+
+
+def read_png(name, content):
+    """Returns the pixels of an 8bit, non-interlaced RGB(A) or palette PNG as rows of RGBA tuples."""
+    if content[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s is not a PNG" % name)
+    pos = 8
+    idat = bytearray()
+    palette, transparency = [], b""
+    while pos < len(content):
+        length, chunk = struct.unpack_from(">I4s", content, pos)
+        body = content[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if chunk == b"IHDR":
+            width, height, depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif chunk == b"PLTE":
+            palette = [tuple(body[i:i + 3]) for i in range(0, length, 3)]
+        elif chunk == b"tRNS":
+            transparency = body
+        elif chunk == b"IDAT":
+            idat += body
+    if depth != 8 or interlace != 0 or color_type not in (2, 3, 6):
+        raise ValueError("%s: unsupported PNG type" % name)
+
+    bpp = {2: 3, 3: 1, 6: 4}[color_type]
+    stride = width * bpp
+    raw = zlib.decompress(bytes(idat))
+    previous = bytearray(stride)
+    rows = []
+    for row in range(height):
+        start = row * (stride + 1)
+        line_filter = raw[start]
+        line = bytearray(raw[start + 1:start + 1 + stride])
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = previous[i]
+            up_left = previous[i - bpp] if i >= bpp else 0
+            if line_filter == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif line_filter == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif line_filter == 3:
+                line[i] = (line[i] + (left + up) // 2) & 0xFF
+            elif line_filter == 4:
+                p = left + up - up_left
+                pa, pb, pc = abs(p - left), abs(p - up), abs(p - up_left)
+                predictor = left if pa <= pb and pa <= pc else (up if pb <= pc else up_left)
+                line[i] = (line[i] + predictor) & 0xFF
+        previous = line
+
+        if color_type == 6:
+            rows.append([tuple(line[i:i + 4]) for i in range(0, stride, 4)])
+        elif color_type == 2:
+            rows.append([tuple(line[i:i + 3]) + (255,) for i in range(0, stride, 3)])
+        else:
+            rows.append([palette[i] + (transparency[i] if i < len(transparency) else 255,)
+                         for i in line])
+    return width, height, rows
+
+
+def read_alpha_png(name, content, width, height):
+    """
+    Returns the center width x height pixels of a PNG as rows of (RGB565, alpha) with 5bit alpha.
+    Translucent pixels are premultiplied per RGB565 channel so that pixel + background * (32 -
+    alpha) / 32 never overflows a channel.
+    """
+    png_width, png_height, png_rows = read_png(name, content)
+    if png_width < width or png_height < height:
+        raise ValueError("%s is smaller than its BMP" % name)
+    left, top = (png_width - width) // 2, (png_height - height) // 2
+    rows = []
+    for png_row in png_rows[top:top + height]:
+        pixels = []
+        for r, g, b, a in png_row[left:left + width]:
+            alpha = (a * ALPHA_OPAQUE + 127) // 255
+            r5, g6, b5 = r >> 3, g >> 2, b >> 3
+            if 0 < alpha < ALPHA_OPAQUE:
+                r5, g6, b5 = r5 * alpha >> 5, g6 * alpha >> 5, b5 * alpha >> 5
+            pixels.append(((r5 << 11) | (g6 << 5) | b5, alpha))
+        rows.append(pixels)
+    return rows
+
+
+def encode_rle_row(pixels, alphas=None):
+    """
+    Encodes a row of RGB565 pixels. With alphas, transparent instead of black pixels are skipped and
+    translucent ones go into blend packets.
+    """
+    encoded = bytearray()
+    literals = []
+
+    def kind(i):
+        if alphas is None:
+            return "opaque"
+        if alphas[i] == 0:
+            return "transparent"
+        return "opaque" if alphas[i] == ALPHA_OPAQUE else "translucent"
+
+    def flush_literals():
+        for i in range(0, len(literals), RLE_MAX_COUNT):
+            chunk = literals[i:i + RLE_MAX_COUNT]
+            encoded.append(RLE_LITERAL | (len(chunk) - 1))
+            for pixel in chunk:
+                encoded.extend(struct.pack("<H", pixel))
+        literals.clear()
+
+    i = 0
+    while i < len(pixels):
+        pixel_kind = kind(i)
+        if pixel_kind != "opaque":
+            run = 1
+            while i + run < len(pixels) and kind(i + run) == pixel_kind:
+                run += 1
+            flush_literals()
+            for j in range(i, i + run, RLE_MAX_COUNT):
+                count = min(i + run - j, RLE_MAX_COUNT)
+                if pixel_kind == "transparent":
+                    encoded.append(RLE_SKIP | (count - 1))
+                else:
+                    encoded.append(RLE_BLEND | (count - 1))
+                    encoded.extend(struct.pack("<%dH" % count, *pixels[j:j + count]))
+                    encoded.extend(bytes(alphas[j:j + count]))
+            i += run
+            continue
+
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == pixels[i] and kind(i + run) == "opaque":
+            run += 1
+        if pixels[i] == 0 and run >= RLE_MIN_SKIP and alphas is None:
+            flush_literals()
+            for j in range(0, run, RLE_MAX_COUNT):
+                encoded.append(RLE_SKIP | (min(run - j, RLE_MAX_COUNT) - 1))
+        elif run >= RLE_MIN_RUN:
+            flush_literals()
+            for j in range(0, run, RLE_MAX_COUNT):
+                encoded.append(RLE_RUN | (min(run - j, RLE_MAX_COUNT) - 1))
+                encoded.extend(struct.pack("<H", pixels[i]))
+        else:
+            literals.extend(pixels[i:i + run])
+        i += run
+    flush_literals()
+    return encoded
+
+
+def convert_alpha_image(name, width, height, png):
+    rows = read_alpha_png(name, png, width, height)
+    rle = b"".join(encode_rle_row([pixel for pixel, _ in row], [alpha for _, alpha in row])
+                   for row in rows)
+    return struct.pack(IMAGE_HEADER_FORMAT, IMAGE_MAGIC, IMAGE_FORMAT_RLE565_ALPHA, 0, width,
+                       height) + rle
+
+
+def convert_bmp(name, content, png=None):
+    """
+    Converts a 24bit BMP to an RGB565 image, run-length encoded if that makes it smaller. With the
+    source PNG of the BMP it becomes an RLE image with alpha channel instead.
+    """
+    width, height, rows = read_bmp(name, content)
+    if png is not None:
+        return convert_alpha_image(name, width, height, png)
+    raw = b"".join(struct.pack("<%dH" % width, *pixels) for pixels in rows)
+    rle = b"".join(encode_rle_row(pixels) for pixels in rows)
+    if len(rle) < len(raw):
+        image_format, pixels = IMAGE_FORMAT_RLE565, rle
+    else:
+        image_format, pixels = IMAGE_FORMAT_RGB565, raw
+    return struct.pack(IMAGE_HEADER_FORMAT, IMAGE_MAGIC, image_format, 0, width, height) + pixels
+
+
+def alpha_source(assets_dir, name):
+    for prefix, source_dir in ALPHA_SOURCES.items():
+        if name.startswith(prefix):
+            path = os.path.join(assets_dir, source_dir, name[len(prefix):-len(".bmp")] + ".png")
+            if os.path.exists(path):
+                with open(path, "rb") as f:
+                    return f.read()
+    return None
+
+
+def convert_images(assets_dir, assets):
+    return [(name, convert_bmp(name, content, alpha_source(assets_dir, name))
+             if name.endswith(".bmp") else content)
+            for name, content in assets]
+
+
+def pack(assets):
+    slot_count = 1
+    while slot_count < 2 * len(assets):
+        slot_count *= 2
+
+    data_offset = struct.calcsize(HEADER_FORMAT) + slot_count * struct.calcsize(SLOT_FORMAT)
+    slots = [(0, 0, 0)] * slot_count
+    data = bytearray()
+    hashes = {}
+    for name, content in assets:
+        h = fnv1a(name)
+        if h in hashes:
+            raise ValueError("hash collision between %s and %s" % (hashes[h], name))
+        hashes[h] = name
+
+        data += b"\0" * (-(data_offset + len(data)) % ALIGNMENT)
+        slot = h & (slot_count - 1)
+        while slots[slot][1] != 0:
+            slot = (slot + 1) & (slot_count - 1)
+        slots[slot] = (h, data_offset + len(data), len(content))
+        data += content
+
+    archive = bytearray(struct.pack(HEADER_FORMAT, MAGIC, VERSION, slot_count, len(assets), 0))
+    for slot in slots:
+        archive += struct.pack(SLOT_FORMAT, *slot)
+    return bytes(archive + data)
+
+
+def check_icons(project_dir, assets):
+    with open(os.path.join(project_dir, "src", "icons.h")) as f:
+        icons = re.findall(r'^\s*WEATHER_ICON\("([^"]+)"\)', f.read(), re.MULTILINE)
+    names = set(name for name, _ in assets)
+    missing = [icon_set + icon + ".bmp" for icon in icons for icon_set in ICON_SETS
+               if icon_set + icon + ".bmp" not in names]
+    if missing:
+        raise ValueError("icons referenced in src/icons.h missing: %s" % ", ".join(missing))
+
+
+def write_if_changed(path, content):
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == content:
+                return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    # a build that's interrupted half-way mustn't leave a truncated archive behind
+    temp_path = path + ".tmp"
+    with open(temp_path, "wb") as f:
+        f.write(content)
+    os.replace(temp_path, path)
+    return True
+
+
+def partition_offset(partition_table, label):
+    with open(partition_table) as f:
+        rows = csv.reader(line for line in f if not line.lstrip().startswith("#"))
+        for row in rows:
+            if row and row[0].strip() == label:
+                return row[3].strip()
+    raise ValueError("partition %s not found in %s" % (label, partition_table))
+
+
+def main(project_dir, partition_image=None):
+    assets_dir = os.path.join(project_dir, "assets")
+    fs_archive = os.path.join(project_dir, "data", "assets.pak")
+    assets = convert_images(assets_dir, collect_assets(os.path.join(assets_dir, "fs")))
+    check_icons(project_dir, assets)
+    if partition_image:
+        target = partition_image
+        if os.path.exists(fs_archive):
+            print("%s isn't used with ASSETS_PARTITION, delete it to save space on the flash FS"
+                  % fs_archive)
+    else:
+        target = fs_archive
+    archive = pack(assets)
+    if write_if_changed(target, archive):
+        print("Packed %d assets into %s (%d bytes)" % (len(assets), target, len(archive)))
+
+
+if __name__ == "__main__":
+    main(os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")))
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    build_flags = env.GetProjectOption("build_flags", "")  # noqa: F821
+    if isinstance(build_flags, list):
+        build_flags = " ".join(build_flags)
+    if re.search(r"-D\s*ASSETS_PARTITION\b", build_flags):
+        image = env.subst("$BUILD_DIR/assets.bin")  # noqa: F821
+        main(env.subst("$PROJECT_DIR"), image)  # noqa: F821
+        table = os.path.join(env.subst("$PROJECT_DIR"),  # noqa: F821
+                             env.GetProjectOption("board_build.partitions"))  # noqa: F821
+        env.AddCustomTarget(  # noqa: F821
+            name="uploadassets",
+            dependencies=None,
+            actions=['"$PYTHONEXE" "$UPLOADER" --chip esp32 --baud $UPLOAD_SPEED '
+                     'write_flash %s "%s"' % (partition_offset(table, "assets"), image)],
+            title="Upload assets",
+            description="Flashes the packed images to the assets partition")
+    else:
+        main(env.subst("$PROJECT_DIR"))  # noqa: F821
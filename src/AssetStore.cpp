@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "AssetStore.h"
+
+#define ASSET_ARCHIVE_MAGIC 0x4B415054 // "TPAK"
+#define ASSET_ARCHIVE_VERSION 1
+
+typedef struct AssetArchiveHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slotCount;
+  uint32_t assetCount;
+  uint32_t reserved;
+} AssetArchiveHeader;
+
+bool AssetStore::begin(fs::FS &fs, const char *path) {
+  _file = fs.open(path, "r");
+  if (!_file) {
+    log_e("Asset archive %s not found.", path);
+    return false;
+  }
+
+  AssetArchiveHeader header;
+  if (_file.read((uint8_t *)&header, sizeof(header)) != sizeof(header) ||
+      !checkHeader(&header, path)) {
+    _file.close();
+    return false;
+  }
+
+  size_t indexSize = header.slotCount * sizeof(AssetSlot);
+  AssetSlot *slots = (AssetSlot *)malloc(indexSize);
+  if (slots == nullptr || _file.read((uint8_t *)slots, indexSize) != indexSize) {
+    log_e("Failed to load asset index of %s.", path);
+    free(slots);
+    _file.close();
+    return false;
+  }
+  _slots = slots;
+  _slotMask = header.slotCount - 1;
+  log_i("Asset archive %s with %d assets loaded.", path, header.assetCount);
+  return true;
+}
+
+bool AssetStore::beginPartition(const char *label) {
+  const esp_partition_t *partition = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (partition == nullptr) {
+    log_e("Asset partition '%s' not found.", label);
+    return false;
+  }
+
+  const void *mapped;
+  esp_err_t err = esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped,
+                                     &_mapHandle);
+  if (err != ESP_OK) {
+    log_e("Failed to map asset partition '%s': %d", label, err);
+    return false;
+  }
+
+  const AssetArchiveHeader *header = (const AssetArchiveHeader *)mapped;
+  if (!checkHeader(header, label)) {
+    spi_flash_munmap(_mapHandle);
+    return false;
+  }
+  _mapped = (const uint8_t *)mapped;
+  // the index is used right where it is in flash, too
+  _slots = (const AssetSlot *)(_mapped + sizeof(AssetArchiveHeader));
+  _slotMask = header->slotCount - 1;
+  log_i("Asset partition '%s' with %d assets mapped.", label, header->assetCount);
+  return true;
+}
+
+bool AssetStore::contains(const char *name) {
+  return find(id(name)) != nullptr;
+}
+
+const uint8_t *AssetStore::map(const char *name, uint32_t *size) {
+  if (_mapped == nullptr) return nullptr;
+  const uint8_t *data = map(id(name), size);
+  if (data == nullptr) log_e("Asset %s not found.", name);
+  return data;
+}
+
+const uint8_t *AssetStore::map(AssetId id, uint32_t *size) {
+  if (_mapped == nullptr) return nullptr;
+  const AssetSlot *slot = find(id);
+  if (slot == nullptr) return nullptr;
+  *size = slot->size;
+  return _mapped + slot->offset;
+}
+
+uint32_t AssetStore::read(const char *name, uint8_t **buffer, uint32_t *capacity) {
+  if (find(id(name)) == nullptr) {
+    log_e("Asset %s not found.", name);
+    return 0;
+  }
+  return read(id(name), buffer, capacity);
+}
+
+uint32_t AssetStore::read(AssetId id, uint8_t **buffer, uint32_t *capacity) {
+  const AssetSlot *slot = find(id);
+  if (slot == nullptr) return 0;
+  _reads++;
+
+  if (*capacity < slot->size) {
+    free(*buffer);
+    *buffer = (uint8_t *)(psramFound() ? ps_malloc(slot->size) : malloc(slot->size));
+    *capacity = *buffer == nullptr ? 0 : slot->size;
+    if (*buffer == nullptr) {
+      log_e("Failed to allocate %d bytes for asset %08x.", slot->size, id);
+      return 0;
+    }
+  }
+
+  if (_mapped != nullptr) {
+    memcpy(*buffer, _mapped + slot->offset, slot->size);
+  } else if (!_file.seek(slot->offset) || _file.read(*buffer, slot->size) != slot->size) {
+    log_e("Failed to read asset %08x.", id);
+    return 0;
+  }
+  return slot->size;
+}
+
+uint32_t AssetStore::reads() {
+  return _reads;
+}
+
+AssetId AssetStore::id(const char *name) {
+  return assetId(name);
+}
+
+bool AssetStore::checkHeader(const void *data, const char *source) {
+  const AssetArchiveHeader *header = (const AssetArchiveHeader *)data;
+  if (header->magic != ASSET_ARCHIVE_MAGIC || header->version != ASSET_ARCHIVE_VERSION ||
+      header->slotCount == 0 || (header->slotCount & (header->slotCount - 1)) != 0) {
+    log_e("Asset archive %s is invalid.", source);
+    return false;
+  }
+  return true;
+}
+
+const AssetSlot *AssetStore::find(AssetId id) {
+  if (_slots == nullptr) return nullptr;
+  // linear probing, the table is at most half full so this stops at an empty slot quickly
+  for (uint16_t i = id & _slotMask;; i = (i + 1) & _slotMask) {
+    if (_slots[i].offset == 0) return nullptr;
+    if (_slots[i].id == id) return &_slots[i];
+  }
+}
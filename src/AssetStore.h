@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <FS.h>
+#include <esp_partition.h>
+
+// Asset names are hashed with 32bit FNV-1a, must match scripts/pack_assets.py.
+#define ASSET_HASH_OFFSET_BASIS 0x811C9DC5
+#define ASSET_HASH_PRIME 0x01000193
+
+typedef uint32_t AssetId;
+
+// Hashes the name at compile time if it's a constant, e.g. for tables of assets.
+constexpr AssetId assetId(const char *name, AssetId hash = ASSET_HASH_OFFSET_BASIS) {
+  return *name == 0 ? hash : assetId(name + 1, (hash ^ (uint8_t)*name) * ASSET_HASH_PRIME);
+}
+
+typedef struct AssetSlot {
+  AssetId id;
+  // 0 marks an unused slot
+  uint32_t offset;
+  uint32_t size;
+} AssetSlot;
+
+/**
+ * Read access to the asset archive built by scripts/pack_assets.py.
+ *
+ * All images and the logo live in a single file on the flash FS. Its hash index is loaded into
+ * RAM once, so looking up an asset doesn't touch the FS metadata and reading it is a single seek
+ * and one contiguous read.
+ *
+ * Alternatively, the archive lives in a raw data partition which is memory-mapped. Assets can then
+ * be used right where they are in flash without copying them to RAM first.
+ */
+class AssetStore {
+public:
+  bool begin(fs::FS &fs, const char *path);
+  bool beginPartition(const char *label);
+  bool contains(const char *name);
+  /**
+   * @param size out, size of the asset
+   * @return pointer to the asset in flash, nullptr if not found or the archive isn't memory-mapped
+   */
+  const uint8_t *map(const char *name, uint32_t *size);
+  // same as above without hashing the name, doesn't log missing assets
+  const uint8_t *map(AssetId id, uint32_t *size);
+  /**
+   * Reads the asset into buffer, (re-)allocating it in PSRAM (if available) when it's too small.
+   *
+   * @param buffer in/out, may point to nullptr initially, free() once no longer needed
+   * @param capacity in/out, size of buffer
+   * @return size of the asset, 0 if not found or not readable
+   */
+  uint32_t read(const char *name, uint8_t **buffer, uint32_t *capacity);
+  uint32_t read(AssetId id, uint8_t **buffer, uint32_t *capacity);
+  // number of assets read from the file system (not mapped) so far
+  uint32_t reads();
+  static AssetId id(const char *name);
+
+private:
+  fs::File _file;
+  const AssetSlot *_slots = nullptr;
+  uint16_t _slotMask = 0;
+  const uint8_t *_mapped = nullptr;
+  uint32_t _reads = 0;
+  spi_flash_mmap_handle_t _mapHandle;
+  const AssetSlot *find(AssetId id);
+  bool checkHeader(const void *data, const char *source);
+};
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "AsyncBlitter.h"
+
+AsyncBlitter::AsyncBlitter(TFT_eSPI *tft) {
+  _tft = tft;
+}
+
+bool AsyncBlitter::begin(BaseType_t core) {
+  // internal RAM, the pixels are read byte by byte while they're sent
+  _buffers = (BlitBuffer *)malloc(BLIT_BUFFER_COUNT * sizeof(BlitBuffer));
+  _pending = xQueueCreate(BLIT_BUFFER_COUNT, sizeof(int8_t));
+  _free = xQueueCreate(BLIT_BUFFER_COUNT, sizeof(int8_t));
+  if (_buffers == nullptr || _pending == nullptr || _free == nullptr) {
+    log_e("Failed to allocate blit buffers.");
+    return false;
+  }
+  for (int8_t i = 0; i < BLIT_BUFFER_COUNT; i++) {
+    xQueueSend(_free, &i, portMAX_DELAY);
+  }
+  if (xTaskCreatePinnedToCore(blitTask, "blit", 4096, this, 2, nullptr, core) != pdPASS) {
+    log_e("Failed to start blit task.");
+    return false;
+  }
+  return true;
+}
+
+uint16_t *AsyncBlitter::reserve(int32_t x, int32_t y, uint16_t w, uint16_t h) {
+  uint32_t count = w * h;
+  if (_buffers == nullptr || count > BLIT_BUFFER_PIXELS) return nullptr;
+
+  if (_current >= 0) {
+    BlitBuffer *buffer = &_buffers[_current];
+    BlitRect *last = &buffer->rects[buffer->rectCount - 1];
+    if (buffer->used + count > BLIT_BUFFER_PIXELS) {
+      flush();
+    } else if (last->x == x && last->w == w && last->y + last->h == y) {
+      // the next rows of the same block, e.g. image rows without skipped pixels
+      last->h += h;
+      buffer->used += count;
+      return buffer->pixels + buffer->used - count;
+    } else if (buffer->rectCount == BLIT_MAX_RECTS) {
+      flush();
+    }
+  }
+
+  if (_current < 0) {
+    xQueueReceive(_free, &_current, portMAX_DELAY);
+    _buffers[_current].used = 0;
+    _buffers[_current].rectCount = 0;
+  }
+  BlitBuffer *buffer = &_buffers[_current];
+  buffer->rects[buffer->rectCount++] = {(int16_t)x, (int16_t)y, w, h, buffer->used};
+  buffer->used += count;
+  return buffer->pixels + buffer->used - count;
+}
+
+void AsyncBlitter::flush() {
+  if (_current < 0) return;
+  xQueueSend(_pending, &_current, portMAX_DELAY);
+  _current = -1;
+}
+
+void AsyncBlitter::wait() {
+  if (_buffers == nullptr) return;
+  flush();
+  // all buffers are back once the task is done with them
+  int8_t buffers[BLIT_BUFFER_COUNT];
+  for (uint8_t i = 0; i < BLIT_BUFFER_COUNT; i++) {
+    xQueueReceive(_free, &buffers[i], portMAX_DELAY);
+  }
+  for (uint8_t i = 0; i < BLIT_BUFFER_COUNT; i++) {
+    xQueueSend(_free, &buffers[i], portMAX_DELAY);
+  }
+}
+
+void AsyncBlitter::setWriteFrequency(uint32_t frequency) {
+  _writeFrequency = frequency;
+}
+
+void AsyncBlitter::blitTask(void *parameter) {
+  AsyncBlitter *blitter = (AsyncBlitter *)parameter;
+  TFT_eSPI *tft = blitter->_tft;
+  int8_t index;
+  while (true) {
+    xQueueReceive(blitter->_pending, &index, portMAX_DELAY);
+    BlitBuffer *buffer = &blitter->_buffers[index];
+
+    bool oldSwap = tft->getSwapBytes();
+    tft->setSwapBytes(true);
+    tft->startWrite();
+    if (blitter->_writeFrequency > 0) tft->getSPIinstance().setFrequency(blitter->_writeFrequency);
+    for (uint8_t i = 0; i < buffer->rectCount; i++) {
+      const BlitRect *rect = &buffer->rects[i];
+      tft->pushImage(rect->x, rect->y, rect->w, rect->h, buffer->pixels + rect->offset);
+    }
+    tft->endWrite();
+    tft->setSwapBytes(oldSwap);
+
+    xQueueSend(blitter->_free, &index, portMAX_DELAY);
+  }
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <TFT_eSPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#define BLIT_BUFFER_COUNT 2
+// pixels and rectangles per buffer, a buffer is handed over to the blit task once either runs out
+#define BLIT_BUFFER_PIXELS 4096
+#define BLIT_MAX_RECTS 32
+
+/**
+ * Double-buffered pixel transfers to the display.
+ *
+ * TFT_eSPI can't use DMA with the ILI9488: it takes 18bit colors over SPI, so every RGB565 pixel
+ * is expanded by the CPU while it's sent. Instead, a task on the other core does the transfers.
+ * The caller decodes into one buffer while the task pushes the other one, e.g. row N+1 of an image
+ * or the next JPEG MCU is decoded while row N or the previous MCU goes out.
+ *
+ * Only one task may use the blitter. Nothing else may draw to the display until wait() returned.
+ */
+class AsyncBlitter {
+public:
+  AsyncBlitter(TFT_eSPI *tft);
+  /**
+   * Allocates the buffers and starts the blit task.
+   *
+   * @param core the core to run the transfers on, the other one than the caller's
+   */
+  bool begin(BaseType_t core);
+  /**
+   * Reserves room for a block of w x h RGB565 pixels (not byte-swapped). The pixels are pushed to
+   * x/y once the buffer is full or on flush()/wait(). Blocks while both buffers are in flight.
+   *
+   * @return where to write the pixels to, nullptr if the block is too large for a buffer or the
+   *         blitter isn't running
+   */
+  uint16_t *reserve(int32_t x, int32_t y, uint16_t w, uint16_t h);
+  // hands the pending blocks over to the blit task
+  void flush();
+  // flushes and blocks until all blocks are on the display
+  void wait();
+  // SPI write clock of the transfers, 0 keeps the one TFT_eSPI was built with
+  void setWriteFrequency(uint32_t frequency);
+
+private:
+  typedef struct BlitRect {
+    int16_t x;
+    int16_t y;
+    uint16_t w;
+    uint16_t h;
+    uint16_t offset;
+  } BlitRect;
+
+  typedef struct BlitBuffer {
+    uint16_t pixels[BLIT_BUFFER_PIXELS];
+    BlitRect rects[BLIT_MAX_RECTS];
+    uint16_t used;
+    uint8_t rectCount;
+  } BlitBuffer;
+
+  TFT_eSPI *_tft;
+  BlitBuffer *_buffers = nullptr;
+  // buffer indexes ready to be pushed and those free to be filled
+  QueueHandle_t _pending = nullptr;
+  QueueHandle_t _free = nullptr;
+  // buffer being filled by the caller, -1 if none
+  int8_t _current = -1;
+  uint32_t _writeFrequency = 0;
+
+  static void blitTask(void *parameter);
+};
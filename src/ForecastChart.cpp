@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "ForecastChart.h"
+
+// room for the temperature labels left of the plot and the weekday labels above it
+#define CHART_MARGIN_LEFT 36
+#define CHART_MARGIN_RIGHT 8
+#define CHART_MARGIN_TOP 20
+#define CHART_MARGIN_BOTTOM 4
+#define CHART_LABEL_FONT_SIZE 14
+#define CHART_LINE_WIDTH 2.0f
+
+// Sprite buffers hold the colors byte-swapped, ready to be pushed to the display.
+static inline uint16_t swap16(uint16_t color) {
+  return (color >> 8) | (color << 8);
+}
+
+// Blends two RGB565 colors with a 5bit alpha in a single multiplication by spreading the channels
+// over 32 bits: 00000gggggg00000rrrrr000000bbbbb
+static inline uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t alpha) {
+  uint32_t a = (alpha + 4) >> 3;
+  uint32_t fg32 = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+  uint32_t bg32 = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+  uint32_t result = ((((fg32 - bg32) * a) >> 5) + bg32) & 0x07E0F81F;
+  return (uint16_t)(result | (result >> 16));
+}
+
+static inline uint8_t coverageToAlpha(float coverage) {
+  return coverage >= 1.0f ? 255 : (uint8_t)(coverage * 255.0f);
+}
+
+// Linear interpolation in the equidistant (3h) series at fractional index u.
+static float sampleAt(const float *values, uint8_t count, float u) {
+  if (u <= 0) return values[0];
+  if (u >= count - 1) return values[count - 1];
+  uint8_t i = (uint8_t)u;
+  return values[i] + (values[i + 1] - values[i]) * (u - i);
+}
+
+ForecastChart::ForecastChart(TFT_eSPI *tft, OpenFontRender *ofr) : _sprite(tft) {
+  _tft = tft;
+  _ofr = ofr;
+}
+
+void ForecastChart::draw(const ForecastRecord *forecasts, uint8_t count,
+                         const String *dayLabels, uint16_t x, uint16_t y, uint16_t w,
+                         uint16_t h) {
+  if (count < 2 || count > WEATHER_SNAPSHOT_FORECASTS || w > CHART_MAX_WIDTH) {
+    log_e("Cannot draw chart with %d forecasts and width %d.", count, w);
+    return;
+  }
+
+  ensureSprite(w, h);
+  _sprite.fillSprite(TFT_BLACK);
+
+  uint16_t plotX = CHART_MARGIN_LEFT;
+  uint16_t plotY = CHART_MARGIN_TOP;
+  uint16_t plotW = w - CHART_MARGIN_LEFT - CHART_MARGIN_RIGHT;
+  uint16_t plotH = h - CHART_MARGIN_TOP - CHART_MARGIN_BOTTOM;
+
+  float temps[WEATHER_SNAPSHOT_FORECASTS];
+  float pops[WEATHER_SNAPSHOT_FORECASTS];
+  float minTemp = 200.0, maxTemp = -200.0;
+  for (uint8_t i = 0; i < count; i++) {
+    temps[i] = displayTemperature(fromHundredths(forecasts[i].temp), _metric);
+    pops[i] = forecasts[i].pop;
+    if (temps[i] < minTemp) minTemp = temps[i];
+    if (temps[i] > maxTemp) maxTemp = temps[i];
+  }
+  // pad the temperature range so the curve never touches the plot borders
+  minTemp = floorf(minTemp - 1);
+  maxTemp = ceilf(maxTemp + 1);
+
+  // vertical pixel position of a value, rows grow downwards
+  float tempScale = (plotH - 1) / (maxTemp - minTemp);
+  // the probability of precipitation always spans 0-100 %
+  float popScale = plotH / 100.0f;
+  float columnsPerSample = (float)plotW / (count - 1);
+  float halfWidth = CHART_LINE_WIDTH / 2;
+
+  for (uint16_t c = 0; c < plotW; c++) {
+    float left = c / columnsPerSample;
+    float center = (c + 0.5f) / columnsPerSample;
+    float right = (c + 1) / columnsPerSample;
+
+    _areaTop[c] = plotY + plotH - sampleAt(pops, count, center) * popScale;
+
+    float yLeft = plotY + (maxTemp - sampleAt(temps, count, left)) * tempScale;
+    float yRight = plotY + (maxTemp - sampleAt(temps, count, right)) * tempScale;
+    float slope = yRight - yLeft;
+    _lineY[c] = plotY + (maxTemp - sampleAt(temps, count, center)) * tempScale;
+    // the perpendicular distance to the segment is the vertical one scaled by cos(atan(slope))
+    _lineInvLength[c] = 1.0f / sqrtf(1.0f + slope * slope);
+    // limit each column to the part of the curve that actually passes through it, otherwise steep
+    // segments would overshoot at the peaks
+    _lineMin[c] = min(yLeft, yRight) - halfWidth - 0.5f;
+    _lineMax[c] = max(yLeft, yRight) + halfWidth + 0.5f;
+  }
+
+  // day boundaries and labels
+  time_t start = forecasts[0].observationTime;
+  time_t end = forecasts[count - 1].observationTime;
+  int16_t dayStartX = plotX;
+  struct tm local;
+  int8_t weekday = toLocal(start, &local)->tm_wday;
+  _ofr->setDrawer(_sprite);
+  _ofr->setFontSize(CHART_LABEL_FONT_SIZE);
+  for (uint8_t i = 1; i <= count; i++) {
+    int16_t midnightX = plotX + plotW;
+    int8_t nextWeekday = weekday;
+    if (i < count) {
+      time_t observationTime = forecasts[i].observationTime;
+      struct tm *localTime = toLocal(observationTime, &local);
+      nextWeekday = localTime->tm_wday;
+      if (nextWeekday == weekday) continue;
+      time_t midnight = observationTime - localTime->tm_hour * 3600 - localTime->tm_min * 60;
+      midnightX = plotX + (midnight - start) * (plotW - 1) / (end - start);
+      _sprite.drawFastVLine(midnightX, plotY, plotH, GRID_COLOR);
+    }
+    // skip labels of partial days that don't leave enough room
+    if (midnightX - dayStartX > 30) {
+      _ofr->cdrawString(dayLabels[weekday].c_str(), (dayStartX + midnightX) / 2, 0);
+    }
+    dayStartX = midnightX;
+    weekday = nextWeekday;
+  }
+
+  rasterize(plotX, plotY, plotW, plotH, CHART_LINE_WIDTH);
+
+  // temperature scale
+  _ofr->drawString((String(maxTemp, 0) + "°").c_str(), 2, plotY - 2);
+  _ofr->drawString((String(minTemp, 0) + "°").c_str(), 2, plotY + plotH - CHART_LABEL_FONT_SIZE);
+  if (_canvas != nullptr) {
+    _ofr->setDrawer(*_canvas);
+    _sprite.pushToSprite(_canvas, x, y);
+  } else {
+    _ofr->setDrawer(*_tft);
+    _sprite.pushSprite(x, y);
+  }
+}
+
+void ForecastChart::setCanvas(TFT_eSprite *canvas) {
+  _canvas = canvas;
+}
+
+void ForecastChart::setMetric(bool metric) {
+  _metric = metric;
+}
+
+void ForecastChart::setLocalTime(ChartLocalTime localTime) {
+  _localTime = localTime;
+}
+
+// localtime() shares its result between tasks, hence localtime_r() if there's no conversion set
+struct tm *ForecastChart::toLocal(time_t timestamp, struct tm *result) {
+  if (_localTime != nullptr) return _localTime(timestamp, result);
+  return localtime_r(&timestamp, result);
+}
+
+void ForecastChart::ensureSprite(uint16_t w, uint16_t h) {
+  if (_sprite.created() && _sprite.width() == w && _sprite.height() == h) return;
+  if (_sprite.created()) _sprite.deleteSprite();
+  _sprite.createSprite(w, h);
+}
+
+void ForecastChart::rasterize(uint16_t plotX, uint16_t plotY, uint16_t plotW, uint16_t plotH,
+                              float lineWidth) {
+  uint16_t *buffer = (uint16_t *)_sprite.getPointer();
+  if (buffer == nullptr) {
+    log_e("Chart sprite not available.");
+    return;
+  }
+  uint16_t stride = _sprite.width();
+  float lineReach = lineWidth / 2 + 0.5f;
+
+  for (uint16_t r = plotY; r < plotY + plotH; r++) {
+    uint16_t *pixel = buffer + r * stride + plotX;
+    float rowCenter = r + 0.5f;
+    for (uint16_t c = 0; c < plotW; c++, pixel++) {
+      float areaCoverage = rowCenter + 0.5f - _areaTop[c];
+      bool onLine = rowCenter >= _lineMin[c] && rowCenter <= _lineMax[c];
+      if (areaCoverage <= 0 && !onLine) continue;
+
+      uint16_t color = swap16(*pixel);
+      if (areaCoverage > 0) {
+        color = blend565(PRECIPITATION_COLOR, color, coverageToAlpha(areaCoverage));
+      }
+      if (onLine) {
+        float lineCoverage = lineReach - fabsf(rowCenter - _lineY[c]) * _lineInvLength[c];
+        if (lineCoverage > 0) {
+          color = blend565(TEMP_COLOR, color, coverageToAlpha(lineCoverage));
+        }
+      }
+      *pixel = swap16(color);
+    }
+  }
+}
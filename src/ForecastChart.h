@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <OpenFontRender.h>
+#include <TFT_eSPI.h>
+
+#include "WeatherSnapshot.h"
+
+// Upper bound for the width of the chart sprite in pixels, sizes the per-column scratch buffers.
+#define CHART_MAX_WIDTH 480
+
+// converts a UTC timestamp to local time like localtime_r(), see setLocalTime()
+typedef struct tm *(*ChartLocalTime)(time_t timestamp, struct tm *result);
+
+/**
+ * Plots temperature and probability of precipitation of the 3h/5d OWM forecasts as a line/area
+ * chart.
+ *
+ * Both series are rasterized with anti-aliasing directly into the (16bit) buffer of a sprite. The
+ * buffer is written row by row from a handful of per-column values rather than through thousands
+ * of drawPixel() calls. The finished sprite is pushed to the display in one go.
+ */
+class ForecastChart {
+public:
+  ForecastChart(TFT_eSPI *tft, OpenFontRender *ofr);
+  /**
+   * @param forecasts 3h forecast containers, ordered by observation time
+   * @param count number of entries in forecasts
+   * @param dayLabels 7 weekday labels, Sunday first
+   */
+  void draw(const ForecastRecord *forecasts, uint8_t count, const String *dayLabels, uint16_t x,
+            uint16_t y, uint16_t w, uint16_t h);
+  // the finished chart goes to this sprite (see ShadowFrame) instead of the display if set
+  void setCanvas(TFT_eSprite *canvas);
+  // temperatures in °F if false, the probability of precipitation has no unit
+  void setMetric(bool metric);
+  // day boundaries are found with this conversion if set, e.g. the cached one of localclock.h,
+  // rather than evaluating the TZ rules with localtime_r() for every forecast
+  void setLocalTime(ChartLocalTime localTime);
+
+  static const uint16_t TEMP_COLOR = 0xFD20;
+  static const uint16_t PRECIPITATION_COLOR = 0x0336;
+  static const uint16_t GRID_COLOR = 0x4228;
+
+private:
+  TFT_eSPI *_tft;
+  OpenFontRender *_ofr;
+  TFT_eSprite _sprite;
+  TFT_eSprite *_canvas = nullptr;
+  bool _metric = true;
+  ChartLocalTime _localTime = nullptr;
+
+  // per-column scratch values, top edge of the precipitation area and center line of the temp curve
+  float _areaTop[CHART_MAX_WIDTH];
+  float _lineY[CHART_MAX_WIDTH];
+  float _lineMin[CHART_MAX_WIDTH];
+  float _lineMax[CHART_MAX_WIDTH];
+  float _lineInvLength[CHART_MAX_WIDTH];
+
+  void ensureSprite(uint16_t w, uint16_t h);
+  struct tm *toLocal(time_t timestamp, struct tm *result);
+  void rasterize(uint16_t plotX, uint16_t plotY, uint16_t plotW, uint16_t plotH,
+                 float lineWidth);
+};
@@ -7,115 +7,468 @@
 
 #define FS_TP_LOGO "/ThingPulse-logo-260.jpeg"
 
-GfxUi::GfxUi(TFT_eSPI *tft, OpenFontRender *ofr) {
+// Sprite buffers hold the colors byte-swapped, ready to be pushed to the display.
+static inline uint16_t swap16(uint16_t color) {
+  return (color >> 8) | (color << 8);
+}
+
+// Swaps the bytes of both pixels packed into a 32bit word at once.
+static inline uint32_t swap16x2(uint32_t pixels) {
+  return ((pixels & 0x00FF00FF) << 8) | ((pixels >> 8) & 0x00FF00FF);
+}
+
+// Pixel data in the images isn't necessarily aligned.
+static inline uint32_t load32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Blends a premultiplied color over the background in a single multiplication by spreading the
+// channels over 32 bits: 00000gggggg00000rrrrr000000bbbbb
+// The image converter premultiplies such that the channels can't overflow.
+static inline uint16_t blendPremultiplied565(uint16_t color, uint16_t background, uint8_t alpha) {
+  uint32_t bg32 = (background | ((uint32_t)background << 16)) & 0x07E0F81F;
+  bg32 = ((bg32 * (ALPHA_OPAQUE - alpha)) >> 5) & 0x07E0F81F;
+  return color + (uint16_t)(bg32 | (bg32 >> 16));
+}
+
+// The span functions below write to a sprite buffer two pixels per 32bit word once aligned, sprite
+// buffers themselves are always 32bit aligned.
+
+static void copySpan(uint16_t *dst, const uint8_t *src, uint16_t count) {
+  if (count > 0 && ((uintptr_t)dst & 2)) {
+    *dst++ = (src[0] << 8) | src[1];
+    src += 2;
+    count--;
+  }
+  uint32_t *dst32 = (uint32_t *)dst;
+  for (; count >= 2; count -= 2, src += 4) {
+    *dst32++ = swap16x2(load32(src));
+  }
+  if (count > 0) *(uint16_t *)dst32 = (src[0] << 8) | src[1];
+}
+
+static void fillSpan(uint16_t *dst, uint16_t color, uint16_t count) {
+  color = swap16(color);
+  if (count > 0 && ((uintptr_t)dst & 2)) {
+    *dst++ = color;
+    count--;
+  }
+  uint32_t pair = color | ((uint32_t)color << 16);
+  uint32_t *dst32 = (uint32_t *)dst;
+  for (; count >= 2; count -= 2) {
+    *dst32++ = pair;
+  }
+  if (count > 0) *(uint16_t *)dst32 = color;
+}
+
+// Each pixel has an alpha of its own, so the blending itself takes one multiplication per pixel.
+static void blendSpan(uint16_t *dst, const uint8_t *colors, const uint8_t *alphas,
+                      uint16_t count) {
+  if (count > 0 && ((uintptr_t)dst & 2)) {
+    *dst = swap16(blendPremultiplied565(colors[0] | (colors[1] << 8), swap16(*dst), *alphas++));
+    dst++;
+    colors += 2;
+    count--;
+  }
+  uint32_t *dst32 = (uint32_t *)dst;
+  for (; count >= 2; count -= 2, colors += 4, alphas += 2) {
+    uint32_t background = swap16x2(*dst32);
+    uint32_t pair = load32(colors);
+    uint32_t blended = blendPremultiplied565(pair, background, alphas[0]) |
+                       (blendPremultiplied565(pair >> 16, background >> 16, alphas[1]) << 16);
+    *dst32++ = swap16x2(blended);
+  }
+  if (count > 0) {
+    dst = (uint16_t *)dst32;
+    *dst = swap16(blendPremultiplied565(colors[0] | (colors[1] << 8), swap16(*dst), *alphas));
+  }
+}
+
+GfxUi::GfxUi(TFT_eSPI *tft, OpenFontRender *ofr, AssetStore *assets) {
   _tft = tft;
   _ofr = ofr;
+  _assets = assets;
 }
 
-// Bodmer's streamlined x2 faster "no seek" version
 void GfxUi::drawBmp(String filename, uint16_t x, uint16_t y) {
 
   if ((x >= _tft->width()) || (y >= _tft->height()))
     return;
 
-  fs::File bmpFS;
+  uint32_t size = 0;
+  const uint8_t *data = loadAsset(filename.c_str(), &size);
+  if (data == nullptr) {
+    log_e(" File not found");
+    return;
+  }
+  drawImage(data, size, x, y);
+}
+
+void GfxUi::drawBmp(AssetId id, uint16_t x, uint16_t y) {
+  if ((x >= _tft->width()) || (y >= _tft->height()))
+    return;
+
+  uint32_t size = 0;
+  const uint8_t *data = loadAsset(id, &size);
+  if (data == nullptr) {
+    log_e("Asset %08x not found.", id);
+    return;
+  }
+  drawImage(data, size, x, y);
+}
+
+void GfxUi::drawImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y) {
+  // the BMPs in the asset archive were converted at build time
+  const ImageHeader *header = (const ImageHeader *)data;
+  bool converted = size >= sizeof(ImageHeader) && header->magic == IMAGE_MAGIC;
+  // decoded straight into the canvas buffer, translucent pixels blended with what's there
+  if (converted && _canvas != nullptr && _canvas->getColorDepth() == 16 &&
+      _canvas->getPointer() != nullptr) {
+    compositeImage(_canvas, data, size, x, y);
+    return;
+  }
+  if (converted) {
+    if (header->format == IMAGE_FORMAT_RLE565 || header->format == IMAGE_FORMAT_RLE565_ALPHA) {
+      pushRleImage(data, size, x, y);
+    } else {
+      pushRawImage(data, size, x, y);
+    }
+  } else {
+    pushBmp(data, size, x, y);
+  }
+  if (_blitter != nullptr) _blitter->wait();
+}
 
-  // Note: ESP32 passes "open" test even if file does not exist, whereas ESP8266
-  // returns NULL
-  if (!LittleFS.exists(filename)) {
+bool GfxUi::compositeImage(TFT_eSprite *sprite, String filename, int16_t x, int16_t y) {
+  uint32_t size = 0;
+  const uint8_t *data = loadAsset(filename.c_str(), &size);
+  if (data == nullptr) {
     log_e(" File not found");
+    return false;
+  }
+  return compositeImage(sprite, data, size, x, y);
+}
+
+bool GfxUi::compositeImage(TFT_eSprite *sprite, const uint8_t *data, uint32_t size, int16_t x,
+                           int16_t y) {
+  uint16_t *buffer = (uint16_t *)sprite->getPointer();
+  if (buffer == nullptr || sprite->getColorDepth() != 16) {
+    log_e("Can only composite onto created 16bit sprites.");
+    return false;
+  }
+
+  const ImageHeader *header = (const ImageHeader *)data;
+  if (size < sizeof(ImageHeader) || header->magic != IMAGE_MAGIC) {
+    log_e("Image format not recognized.");
+    return false;
+  }
+  if (header->format == IMAGE_FORMAT_RGB565) {
+    return compositeRawImage(data, size, buffer, sprite->width(), sprite->height(), x, y);
+  }
+  return compositeRleImage(data, size, buffer, sprite->width(), sprite->height(), x, y);
+}
+
+void GfxUi::drawLogo() {
+  if (_logo == nullptr && !decodeLogo()) return;
+  pushBlock((_tft->width() - _logoWidth) / 2, 30, _logoWidth, _logoHeight, _logo);
+  if (_blitter != nullptr) _blitter->wait();
+}
+
+// The logo is decoded at 0/0, the decoder's callback is expected to push the MCUs through
+// pushBlock() which collects them in the cache.
+bool GfxUi::decodeLogo() {
+  uint32_t size = 0;
+  const uint8_t *data = loadAsset(FS_TP_LOGO, &size);
+  if (data == nullptr) return false;
+
+  // only parses the header
+  TJpgDec.getJpgSize(&_logoWidth, &_logoHeight, data, size);
+  _logo = (uint16_t *)ps_malloc(_logoWidth * _logoHeight * 2);
+  if (_logo == nullptr) {
+    log_e("Failed to allocate %u bytes for the logo.", _logoWidth * _logoHeight * 2);
+    return false;
+  }
+  _decodingLogo = true;
+  JRESULT result = TJpgDec.drawJpg(0, 0, data, size);
+  _decodingLogo = false;
+  if (result != JDR_OK) {
+    log_e("Failed to decode the logo: %d", result);
+    free(_logo);
+    _logo = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void GfxUi::pushBlock(int32_t x, int32_t y, uint16_t w, uint16_t h, const uint16_t *pixels) {
+  if (_decodingLogo) {
+    // MCUs at the right and bottom edges may stick out of the image
+    uint16_t visibleW = min((int32_t)w, _logoWidth - x);
+    for (uint16_t row = 0; row < h && y + row < _logoHeight; row++) {
+      memcpy(_logo + (y + row) * _logoWidth + x, pixels + row * w, visibleW * 2);
+    }
+    return;
+  }
+  if (_canvas != nullptr) {
+    // the canvas holds the pixels byte-swapped like the display expects them
+    bool oldSwap = _canvas->getSwapBytes();
+    _canvas->setSwapBytes(true);
+    _canvas->pushImage(x, y, w, h, pixels);
+    _canvas->setSwapBytes(oldSwap);
     return;
   }
 
-  // Open requested file
-  bmpFS = LittleFS.open(filename, "r");
+  uint16_t *buffer = _blitter != nullptr ? _blitter->reserve(x, y, w, h) : nullptr;
+  if (buffer != nullptr) {
+    memcpy(buffer, pixels, w * h * 2);
+    return;
+  }
+
+  // too large for the blitter, the transfers must not overlap
+  if (_blitter != nullptr) _blitter->wait();
+  bool oldSwap = _tft->getSwapBytes();
+  _tft->setSwapBytes(true);
+  _tft->pushImage(x, y, w, h, pixels);
+  _tft->setSwapBytes(oldSwap);
+}
+
+void GfxUi::setBlitter(AsyncBlitter *blitter) {
+  _blitter = blitter;
+}
 
-  uint32_t seekOffset;
+void GfxUi::setCanvas(TFT_eSprite *canvas) {
+  _canvas = canvas;
+}
+
+// Uses the asset right from flash if the asset archive is memory-mapped, copies it to the asset
+// buffer otherwise.
+const uint8_t *GfxUi::loadAsset(const char *name, uint32_t *size) {
+  const uint8_t *data = _assets->map(name, size);
+  if (data != nullptr) return data;
+
+  *size = _assets->read(name, &_assetBuffer, &_assetBufferSize);
+  return *size > 0 ? _assetBuffer : nullptr;
+}
+
+const uint8_t *GfxUi::loadAsset(AssetId id, uint32_t *size) {
+  const uint8_t *data = _assets->map(id, size);
+  if (data != nullptr) return data;
+
+  *size = _assets->read(id, &_assetBuffer, &_assetBufferSize);
+  return *size > 0 ? _assetBuffer : nullptr;
+}
+
+// Bodmer's streamlined x2 faster "no seek" version, working on the asset loaded in one go
+void GfxUi::pushBmp(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y) {
+  uint32_t dataOffset;
   uint16_t w, h, row;
   uint8_t r, g, b;
-  bool oldSwap = false;
-
-  if (read16(bmpFS) == 0x4D42) {
-    read32(bmpFS);
-    read32(bmpFS);
-    seekOffset = read32(bmpFS);
-    read32(bmpFS);
-    w = read32(bmpFS);
-    h = read32(bmpFS);
-
-    if ((read16(bmpFS) == 1) && (read16(bmpFS) == 24) && (read32(bmpFS) == 0)) {
-      y += h - 1;
-
-      oldSwap = _tft->getSwapBytes();
-      _tft->setSwapBytes(true);
-      bmpFS.seek(seekOffset);
-
-      // Calculate padding to avoid seek
-      uint16_t padding = (4 - ((w * 3) & 3)) & 3;
-      uint8_t lineBuffer[w * 3 + padding];
-
-      for (row = 0; row < h; row++) {
-
-        bmpFS.read(lineBuffer, sizeof(lineBuffer));
-        uint8_t *bptr = lineBuffer;
-        uint16_t *tptr = (uint16_t *)lineBuffer;
-        // Convert 24 to 16 bit colours using the same line buffer for results
-        for (uint16_t col = 0; col < w; col++) {
-          b = *bptr++;
-          g = *bptr++;
-          r = *bptr++;
-          *tptr++ = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
-        }
 
-        // Push the pixel row to screen, pushImage will crop the line if needed
-        // y is decremented as the BMP image is drawn bottom up
-        _tft->pushImage(x, y--, w, 1, (uint16_t *)lineBuffer);
+  // smaller than the BMP headers
+  if (size < 54 || read16(data) != 0x4D42) {
+    log_e("BMP format not recognized.");
+    return;
+  }
+
+  dataOffset = read32(data + 10);
+  w = read32(data + 18);
+  h = read32(data + 22);
+
+  // Calculate padding to avoid seek
+  uint16_t padding = (4 - ((w * 3) & 3)) & 3;
+  uint32_t rowSize = w * 3 + padding;
+
+  if ((read16(data + 26) == 1) && (read16(data + 28) == 24) && (read32(data + 30) == 0) &&
+      (dataOffset + h * rowSize <= size)) {
+    y += h - 1;
+
+    uint16_t lineBuffer[w];
+    for (row = 0; row < h; row++) {
+
+      const uint8_t *bptr = data + dataOffset + row * rowSize;
+      uint16_t *tptr = lineBuffer;
+      // Convert 24 to 16 bit colours
+      for (uint16_t col = 0; col < w; col++) {
+        b = *bptr++;
+        g = *bptr++;
+        r = *bptr++;
+        *tptr++ = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
       }
-    } else
-      log_e("BMP format not recognized.");
+
+      // Push the pixel row to screen, pushImage will crop the line if needed
+      // y is decremented as the BMP image is drawn bottom up
+      pushBlock(x, y--, w, 1, lineBuffer);
+    }
+  } else
+    log_e("BMP format not recognized.");
+}
+
+// The pixels are pushed straight from where they are, no copy required.
+void GfxUi::pushRawImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y) {
+  const ImageHeader *header = (const ImageHeader *)data;
+  if (header->format != IMAGE_FORMAT_RGB565 ||
+      sizeof(ImageHeader) + header->width * header->height * 2 > size) {
+    log_e("Image format not recognized.");
+    return;
   }
-  _tft->setSwapBytes(oldSwap);
-  bmpFS.close();
+
+  pushBlock(x, y, header->width, header->height, (const uint16_t *)(data + sizeof(ImageHeader)));
 }
 
-void GfxUi::drawLogo() {
-  if (LittleFS.exists(FS_TP_LOGO)) {
-    uint16_t w = 0, h = 0;
-    TJpgDec.getFsJpgSize(&w, &h, FS_TP_LOGO, LittleFS);
-    TJpgDec.drawFsJpg((_tft->width() - w) / 2, 30, FS_TP_LOGO, LittleFS);
+// Expands the runs of each row into a line buffer and pushes the spans between skipped (black or
+// transparent) pixels. Those are not sent to the display at all, it's expected to be black already.
+// There's no read-back from the display, so translucent pixels are drawn as blended onto black.
+void GfxUi::pushRleImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y) {
+  const ImageHeader *header = (const ImageHeader *)data;
+  uint16_t w = header->width;
+  uint16_t h = header->height;
+  const uint8_t *pptr = data + sizeof(ImageHeader);
+  const uint8_t *end = data + size;
+  uint16_t lineBuffer[w];
+  bool valid = true;
+
+  for (uint16_t row = 0; row < h && valid; row++) {
+    uint16_t col = 0;
+    uint16_t spanStart = 0;
+    while (col < w) {
+      uint8_t control = pptr < end ? *pptr++ : 0;
+      uint8_t count = (control & RLE_COUNT_MASK) + 1;
+      uint8_t type = control & RLE_TYPE_MASK;
+      uint8_t dataSize = rleDataSize(type, count);
+      if (pptr + dataSize > end || col + count > w) {
+        valid = false;
+        break;
+      }
+
+      if (type == RLE_SKIP) {
+        if (col > spanStart) {
+          pushBlock(x + spanStart, y + row, col - spanStart, 1, lineBuffer + spanStart);
+        }
+        col += count;
+        spanStart = col;
+      } else if (type == RLE_RUN) {
+        // pixel data isn't necessarily 16bit aligned
+        uint16_t color = pptr[0] | (pptr[1] << 8);
+        for (uint8_t i = 0; i < count; i++) lineBuffer[col++] = color;
+      } else {
+        // the premultiplied colors of blend packets are exactly that
+        memcpy(lineBuffer + col, pptr, 2 * count);
+        col += count;
+      }
+      pptr += dataSize;
+    }
+    if (valid && col > spanStart) {
+      pushBlock(x + spanStart, y + row, col - spanStart, 1, lineBuffer + spanStart);
+    }
+  }
+
+  if (!valid) log_e("RLE image data corrupt.");
+}
+
+// Copies the pixels to the sprite buffer with the bytes swapped, clipped at the sprite borders.
+bool GfxUi::compositeRawImage(const uint8_t *data, uint32_t size, uint16_t *buffer,
+                              int16_t stride, int16_t height, int16_t x, int16_t y) {
+  const ImageHeader *header = (const ImageHeader *)data;
+  int16_t w = header->width;
+  int16_t h = header->height;
+  if (sizeof(ImageHeader) + w * h * 2 > size) {
+    log_e("Image format not recognized.");
+    return false;
+  }
+
+  int16_t first = max(0, -x);
+  int16_t last = min(w, (int16_t)(stride - x));
+  const uint8_t *pixels = data + sizeof(ImageHeader);
+  for (int16_t row = max(0, -y); row < h && y + row < height && last > first; row++) {
+    copySpan(buffer + (y + row) * stride + x + first, pixels + (row * w + first) * 2, last - first);
+  }
+  return true;
+}
+
+// Decodes the packets straight into the sprite buffer. Transparent and opaque pixels are skipped or
+// copied, only translucent ones are blended with what's in the sprite. Skipped pixels of images
+// without alpha channel are black.
+bool GfxUi::compositeRleImage(const uint8_t *data, uint32_t size, uint16_t *buffer,
+                              int16_t stride, int16_t height, int16_t x, int16_t y) {
+  const ImageHeader *header = (const ImageHeader *)data;
+  if (header->format != IMAGE_FORMAT_RLE565 && header->format != IMAGE_FORMAT_RLE565_ALPHA) {
+    log_e("Image format not recognized.");
+    return false;
+  }
+  bool transparentSkips = header->format == IMAGE_FORMAT_RLE565_ALPHA;
+  int16_t w = header->width;
+  int16_t h = header->height;
+  const uint8_t *pptr = data + sizeof(ImageHeader);
+  const uint8_t *end = data + size;
+
+  // rows below the sprite don't need to be decoded at all
+  for (int16_t row = 0; row < h && y + row < height; row++) {
+    bool visible = y + row >= 0;
+    uint16_t *rowBuffer = buffer + (y + row) * stride + x;
+    int16_t col = 0;
+    while (col < w) {
+      uint8_t control = pptr < end ? *pptr++ : 0;
+      uint8_t count = (control & RLE_COUNT_MASK) + 1;
+      uint8_t type = control & RLE_TYPE_MASK;
+      uint8_t dataSize = rleDataSize(type, count);
+      if (pptr + dataSize > end || col + count > w) {
+        log_e("RLE image data corrupt.");
+        return false;
+      }
+
+      // part of the packet within the sprite
+      int16_t first = max(0, -(x + col));
+      int16_t last = min((int16_t)count, (int16_t)(stride - x - col));
+      if (visible && last > first) {
+        uint16_t *dst = rowBuffer + col + first;
+        uint8_t n = last - first;
+        if (type == RLE_LITERAL) {
+          copySpan(dst, pptr + 2 * first, n);
+        } else if (type == RLE_RUN) {
+          fillSpan(dst, pptr[0] | (pptr[1] << 8), n);
+        } else if (type == RLE_BLEND) {
+          blendSpan(dst, pptr + 2 * first, pptr + 2 * count + first, n);
+        } else if (!transparentSkips) {
+          fillSpan(dst, TFT_BLACK, n);
+        }
+      }
+      col += count;
+      pptr += dataSize;
+    }
   }
+  return true;
 }
 
-void GfxUi::drawProgressBar(uint16_t x0, uint16_t y0, uint16_t w, uint16_t h,
-                            uint8_t percentage, uint16_t frameColor,
-                            uint16_t barColor) {
-  if (percentage == 0) {
-    _tft->fillRoundRect(x0, y0, w, h, 3, TFT_BLACK);
+// Bytes following the control byte of an RLE packet.
+uint8_t GfxUi::rleDataSize(uint8_t type, uint8_t count) {
+  switch (type) {
+  case RLE_LITERAL:
+    return 2 * count;
+  case RLE_RUN:
+    return 2;
+  case RLE_BLEND:
+    return 3 * count;
+  default:
+    return 0;
   }
-  uint8_t margin = 2;
-  uint16_t barHeight = h - 2 * margin;
-  uint16_t barWidth = w - 2 * margin;
-  _tft->drawRoundRect(x0, y0, w, h, 3, frameColor);
-  _tft->fillRect(x0 + margin, y0 + margin, barWidth * percentage / 100.0,
-                 barHeight, barColor);
 }
 
-// These read 16- and 32-bit types from the SD card file.
+// These read 16- and 32-bit types from the asset buffer.
 // BMP data is stored little-endian, Arduino is little-endian too.
 // May need to reverse subscript order if porting elsewhere.
 
-uint16_t GfxUi::read16(fs::File &f) {
+uint16_t GfxUi::read16(const uint8_t *p) {
   uint16_t result;
-  ((uint8_t *)&result)[0] = f.read(); // LSB
-  ((uint8_t *)&result)[1] = f.read(); // MSB
+  ((uint8_t *)&result)[0] = p[0]; // LSB
+  ((uint8_t *)&result)[1] = p[1]; // MSB
   return result;
 }
 
-uint32_t GfxUi::read32(fs::File &f) {
+uint32_t GfxUi::read32(const uint8_t *p) {
   uint32_t result;
-  ((uint8_t *)&result)[0] = f.read(); // LSB
-  ((uint8_t *)&result)[1] = f.read();
-  ((uint8_t *)&result)[2] = f.read();
-  ((uint8_t *)&result)[3] = f.read(); // MSB
+  ((uint8_t *)&result)[0] = p[0]; // LSB
+  ((uint8_t *)&result)[1] = p[1];
+  ((uint8_t *)&result)[2] = p[2];
+  ((uint8_t *)&result)[3] = p[3]; // MSB
   return result;
 }
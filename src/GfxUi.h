@@ -5,31 +5,101 @@
 
 #pragma once
 
-#include <FS.h>
-#include <LittleFS.h>
 #include <OpenFontRender.h>
 #include <TFT_eSPI.h>
 
 // JPEG decoder library
 #include <TJpg_Decoder.h>
 
+#include "AssetStore.h"
+#include "AsyncBlitter.h"
+
 // Maximum of 85 for BUFFPIXEL as 3 x this value is stored in an 8 bit variable!
 // 32 is an efficient size for LittleFS due to SPI hardware pipeline buffer size
 // A larger value of 80 is better for SD cards
 #define BUFFPIXEL 32
 
+// Images as converted by scripts/pack_assets.py, the pixels follow the header row by row. They are
+// either raw or run-length encoded, see the script for the packet format. RLE images with alpha
+// channel skip transparent instead of black pixels and carry translucent ones in blend packets.
+#define IMAGE_MAGIC 0x4954 // "TI"
+#define IMAGE_FORMAT_RGB565 0
+#define IMAGE_FORMAT_RLE565 1
+#define IMAGE_FORMAT_RLE565_ALPHA 2
+#define RLE_TYPE_MASK 0xC0
+#define RLE_COUNT_MASK 0x3F
+#define RLE_LITERAL 0x00
+#define RLE_RUN 0x40
+#define RLE_SKIP 0x80
+#define RLE_BLEND 0xC0
+// 5bit alpha of blend packets, premultiplied pixel + background * (ALPHA_OPAQUE - alpha) / 32
+#define ALPHA_OPAQUE 32
+
+typedef struct ImageHeader {
+  uint16_t magic;
+  uint8_t format;
+  uint8_t reserved;
+  uint16_t width;
+  uint16_t height;
+} ImageHeader;
+
 class GfxUi {
 public:
-  GfxUi(TFT_eSPI *tft, OpenFontRender *render);
+  GfxUi(TFT_eSPI *tft, OpenFontRender *render, AssetStore *assets);
   void drawBmp(String filename, uint16_t x, uint16_t y);
+  // same as above with the asset already hashed, e.g. from a table of assetId()s
+  void drawBmp(AssetId id, uint16_t x, uint16_t y);
+  /**
+   * Blends an image onto whatever is in the sprite already, e.g. an icon onto a themed background
+   * or another widget. drawBmp() does the same with the canvas if there is one.
+   *
+   * @param x position of the image in the sprite, it's clipped at the sprite borders
+   * @return false if the image is missing or isn't one converted by scripts/pack_assets.py
+   */
+  bool compositeImage(TFT_eSprite *sprite, String filename, int16_t x, int16_t y);
+  /**
+   * Draws the ThingPulse logo centered at the top. It's decoded only the first time, into an RGB565
+   * block in PSRAM, and pushed from there in one go afterwards.
+   */
   void drawLogo();
-  void drawProgressBar(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
-                       uint8_t percentage, uint16_t frameColor,
-                       uint16_t barColor);
+  /**
+   * Pushes RGB565 pixels (not byte-swapped) to the display, through the blitter if there is one.
+   * The pixels are copied then, the caller may reuse its buffer right away.
+   */
+  void pushBlock(int32_t x, int32_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
+  // nullptr pushes all pixels synchronously
+  void setBlitter(AsyncBlitter *blitter);
+  // draws to this sprite (see ShadowFrame) instead of the display, nullptr for the display
+  void setCanvas(TFT_eSprite *canvas);
 
 private:
   TFT_eSPI *_tft;
   OpenFontRender *_ofr;
-  uint16_t read16(fs::File &f);
-  uint32_t read32(fs::File &f);
+  AssetStore *_assets;
+  AsyncBlitter *_blitter = nullptr;
+  TFT_eSprite *_canvas = nullptr;
+  // the decoded logo, while _decodingLogo is set pushBlock() writes to it instead of the display
+  uint16_t *_logo = nullptr;
+  uint16_t _logoWidth = 0;
+  uint16_t _logoHeight = 0;
+  bool _decodingLogo = false;
+  // assets are read into this buffer in one go, it grows to the size of the largest one
+  uint8_t *_assetBuffer = nullptr;
+  uint32_t _assetBufferSize = 0;
+  const uint8_t *loadAsset(const char *name, uint32_t *size);
+  const uint8_t *loadAsset(AssetId id, uint32_t *size);
+  void drawImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y);
+  bool compositeImage(TFT_eSprite *sprite, const uint8_t *data, uint32_t size, int16_t x,
+                      int16_t y);
+  bool decodeLogo();
+  void pushBmp(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y);
+  void pushRawImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y);
+  void pushRleImage(const uint8_t *data, uint32_t size, uint16_t x, uint16_t y);
+  bool compositeRawImage(const uint8_t *data, uint32_t size, uint16_t *buffer, int16_t stride,
+                         int16_t height, int16_t x, int16_t y);
+  bool compositeRleImage(const uint8_t *data, uint32_t size, uint16_t *buffer, int16_t stride,
+                         int16_t height, int16_t x, int16_t y);
+  uint8_t rleDataSize(uint8_t type, uint8_t count);
+  uint16_t read16(const uint8_t *p);
+  uint32_t read32(const uint8_t *p);
 };
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "ProgressBar.h"
+
+// between the frame and the bar
+#define PROGRESS_MARGIN 2
+#define PROGRESS_CORNER_RADIUS 3
+
+ProgressBar::ProgressBar(RenderQueue *queue) {
+  _queue = queue;
+}
+
+void ProgressBar::begin(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t frameColor,
+                        uint16_t barColor) {
+  _x = x;
+  _y = y;
+  _w = w;
+  _h = h;
+  _frameColor = frameColor;
+  _barColor = barColor;
+  _filled = 0;
+  _target = 0;
+  _queue->paint(paintFrame, this);
+  _queue->flush(x, y, w, h);
+}
+
+void ProgressBar::setTarget(uint8_t percentage) {
+  uint16_t target = innerWidth() * min(percentage, (uint8_t)100) / 100;
+  if (target > _target) _target = target;
+}
+
+bool ProgressBar::animate() {
+  if (_filled >= _target) return false;
+  uint16_t step = max(1, (_target - _filled) / PROGRESS_EASING_DIVISOR);
+  int16_t segmentX = _x + PROGRESS_MARGIN + _filled;
+  int16_t segmentY = _y + PROGRESS_MARGIN;
+  _queue->fill(segmentX, segmentY, step, _h - 2 * PROGRESS_MARGIN, _barColor);
+  _queue->flush(segmentX, segmentY, step, _h - 2 * PROGRESS_MARGIN);
+  _filled += step;
+  return true;
+}
+
+uint16_t ProgressBar::innerWidth() {
+  return _w - 2 * PROGRESS_MARGIN;
+}
+
+void ProgressBar::paintFrame(void *context) {
+  ProgressBar *bar = (ProgressBar *)context;
+  TFT_eSPI *canvas = bar->_queue->canvas();
+  canvas->fillRoundRect(bar->_x, bar->_y, bar->_w, bar->_h, PROGRESS_CORNER_RADIUS, TFT_BLACK);
+  canvas->drawRoundRect(bar->_x, bar->_y, bar->_w, bar->_h, PROGRESS_CORNER_RADIUS,
+                        bar->_frameColor);
+}
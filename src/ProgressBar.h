@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "RenderQueue.h"
+
+// the bar closes this share of the remaining gap per frame (1/n), at least a pixel
+#define PROGRESS_EASING_DIVISOR 4
+
+/**
+ * Boot progress bar which eases towards its target one frame at a time.
+ *
+ * The frame of the bar is drawn once by begin(). Every frame then only fills the segment that was
+ * added since the previous one and flushes just the tiles under it, rather than clearing and
+ * refilling the whole bar and hashing the whole shadow frame. Drawing is queued for the display
+ * task, the state is the caller's.
+ */
+class ProgressBar {
+public:
+  ProgressBar(RenderQueue *queue);
+  // draws the empty bar, the area must have been cleared
+  void begin(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t frameColor,
+             uint16_t barColor);
+  // the bar never moves backwards, lower percentages are ignored
+  void setTarget(uint8_t percentage);
+  /**
+   * Moves the bar one frame towards the target.
+   *
+   * @return false if it's there already, nothing was drawn then
+   */
+  bool animate();
+
+private:
+  RenderQueue *_queue;
+  int16_t _x = 0;
+  int16_t _y = 0;
+  uint16_t _w = 0;
+  uint16_t _h = 0;
+  uint16_t _frameColor = 0;
+  uint16_t _barColor = 0;
+  // filled width of the bar (inside the frame) shown and aimed at
+  uint16_t _filled = 0;
+  uint16_t _target = 0;
+
+  uint16_t innerWidth();
+  // on the display task, the geometry doesn't change until the next begin()
+  static void paintFrame(void *context);
+};
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "RenderQueue.h"
+
+static_assert((RENDER_QUEUE_CAPACITY & (RENDER_QUEUE_CAPACITY - 1)) == 0,
+              "RENDER_QUEUE_CAPACITY must be a power of two");
+
+static inline RenderRect unite(const RenderRect &a, const RenderRect &b) {
+  int16_t x = min(a.x, b.x);
+  int16_t y = min(a.y, b.y);
+  int16_t right = max(a.x + a.w, b.x + b.w);
+  int16_t bottom = max(a.y + a.h, b.y + b.h);
+  return {x, y, (int16_t)(right - x), (int16_t)(bottom - y)};
+}
+
+// overlapping or sharing an edge
+static inline bool touches(const RenderRect &a, const RenderRect &b) {
+  return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+static inline int32_t area(const RenderRect &rect) {
+  return (int32_t)rect.w * rect.h;
+}
+
+RenderQueue::RenderQueue(ShadowFrame *frame, OpenFontRender *ofr) : _tail(0), _done(0) {
+  _frame = frame;
+  _ofr = ofr;
+  for (uint32_t i = 0; i < RENDER_QUEUE_CAPACITY; i++) {
+    _cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool RenderQueue::begin(BaseType_t core) {
+  if (xTaskCreatePinnedToCore(renderTask, "display", 8192, this, 2, &_task, core) == pdPASS) {
+    return true;
+  }
+  log_e("Failed to start display task, drawing synchronously.");
+  _task = nullptr;
+  _lock = xSemaphoreCreateMutex();
+  _synchronous = true;
+  // whatever was posted before
+  drain();
+  return false;
+}
+
+void RenderQueue::fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  RenderCommand command = {};
+  command.op = RENDER_FILL;
+  command.rect = {x, y, w, h};
+  command.color = color;
+  post(command);
+}
+
+void RenderQueue::text(const char *text, int16_t x, int16_t y, uint8_t fontSize) {
+  RenderCommand command = {};
+  command.op = RENDER_TEXT;
+  command.rect = {x, y, 0, 0};
+  command.fontSize = fontSize;
+  strlcpy(command.text, text, sizeof(command.text));
+  post(command);
+}
+
+void RenderQueue::paint(RenderPainter painter, void *context) {
+  RenderCommand command = {};
+  command.op = RENDER_PAINT;
+  command.painter = painter;
+  command.context = context;
+  post(command);
+}
+
+void RenderQueue::flush(int16_t x, int16_t y, int16_t w, int16_t h) {
+  RenderCommand command = {};
+  command.op = RENDER_FLUSH;
+  command.rect = {x, y, w, h};
+  post(command);
+}
+
+void RenderQueue::wait() {
+  if (_task == nullptr) return;
+  uint32_t target = _tail.load(std::memory_order_acquire);
+  while ((int32_t)(_done.load(std::memory_order_acquire) - target) < 0) {
+    delay(1);
+  }
+}
+
+TFT_eSPI *RenderQueue::canvas() {
+  return _frame->surface();
+}
+
+void RenderQueue::invalidate(int16_t x, int16_t y, int16_t w, int16_t h) {
+  RenderRect rect = {x, y, w, h};
+  // grow the first area it touches, which may then touch others
+  for (int8_t i = 0; i < _dirtyCount; i++) {
+    if (!touches(_dirty[i], rect)) continue;
+    rect = unite(_dirty[i], rect);
+    _dirty[i] = _dirty[--_dirtyCount];
+    i = -1;
+  }
+  if (_dirtyCount == RENDER_MAX_DIRTY_RECTS) {
+    // merge into the area that grows the least
+    uint8_t best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (uint8_t i = 0; i < _dirtyCount; i++) {
+      int32_t growth = area(unite(_dirty[i], rect)) - area(_dirty[i]);
+      if (growth < bestGrowth) {
+        best = i;
+        bestGrowth = growth;
+      }
+    }
+    rect = unite(_dirty[best], rect);
+    _dirty[best] = _dirty[--_dirtyCount];
+  }
+  _dirty[_dirtyCount++] = rect;
+}
+
+// Claims a slot, copies the command and publishes it (Vyukov's bounded queue).
+void RenderQueue::post(const RenderCommand &command) {
+  uint32_t position = _tail.load(std::memory_order_relaxed);
+  Cell *cell;
+  while (true) {
+    cell = &_cells[position & (RENDER_QUEUE_CAPACITY - 1)];
+    int32_t lag = (int32_t)(cell->sequence.load(std::memory_order_acquire) - position);
+    if (lag == 0) {
+      if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+    } else if (lag < 0) {
+      // full, the display task is busy with a long batch
+      delay(1);
+      position = _tail.load(std::memory_order_relaxed);
+    } else {
+      position = _tail.load(std::memory_order_relaxed);
+    }
+  }
+  cell->command = command;
+  cell->sequence.store(position + 1, std::memory_order_release);
+  if (_task != nullptr) {
+    xTaskNotifyGive(_task);
+  } else if (_synchronous) {
+    // the ring never fills, every post empties it
+    if (_lock != nullptr) xSemaphoreTake(_lock, portMAX_DELAY);
+    drain();
+    if (_lock != nullptr) xSemaphoreGive(_lock);
+  }
+}
+
+bool RenderQueue::take(RenderCommand *command) {
+  Cell *cell = &_cells[_head & (RENDER_QUEUE_CAPACITY - 1)];
+  if (cell->sequence.load(std::memory_order_acquire) != _head + 1) return false;
+  *command = cell->command;
+  cell->sequence.store(_head + RENDER_QUEUE_CAPACITY, std::memory_order_release);
+  _head++;
+  return true;
+}
+
+/**
+ * Folds the next command into the pending one if the result is the same: a paint repeated right
+ * away only needs to run once, fills of the same color that line up make one rectangle.
+ */
+bool RenderQueue::merge(RenderCommand *pending, const RenderCommand &next) {
+  if (pending->op != next.op) return false;
+  if (next.op == RENDER_PAINT) {
+    return pending->painter == next.painter && pending->context == next.context;
+  }
+  if (next.op != RENDER_FILL || pending->color != next.color) return false;
+  const RenderRect &a = pending->rect;
+  const RenderRect &b = next.rect;
+  bool rowAligned = a.y == b.y && a.h == b.h && (a.x + a.w == b.x || b.x + b.w == a.x);
+  bool columnAligned = a.x == b.x && a.w == b.w && (a.y + a.h == b.y || b.y + b.h == a.y);
+  if (!rowAligned && !columnAligned) return false;
+  pending->rect = unite(a, b);
+  return true;
+}
+
+void RenderQueue::execute(const RenderCommand &command) {
+  const RenderRect &rect = command.rect;
+  switch (command.op) {
+  case RENDER_FILL:
+    _frame->surface()->fillRect(rect.x, rect.y, rect.w, rect.h, command.color);
+    break;
+  case RENDER_TEXT:
+    _ofr->setFontSize(command.fontSize);
+    _ofr->cdrawString(command.text, rect.x, rect.y);
+    break;
+  case RENDER_PAINT:
+    command.painter(command.context);
+    break;
+  case RENDER_FLUSH:
+    invalidate(rect.x, rect.y, rect.w, rect.h);
+    break;
+  }
+}
+
+void RenderQueue::flushDirty() {
+  for (uint8_t i = 0; i < _dirtyCount; i++) {
+    _frame->flush(_dirty[i].x, _dirty[i].y, _dirty[i].w, _dirty[i].h);
+  }
+  _dirtyCount = 0;
+}
+
+// Draws and flushes one batch, i.e. whatever is queued. Only one task at a time may call this.
+void RenderQueue::drain() {
+  RenderCommand pending;
+  RenderCommand next;
+  // one command is held back to merge the next one into it
+  bool hasPending = take(&pending);
+  while (hasPending) {
+    bool hasNext = take(&next);
+    if (hasNext && merge(&pending, next)) continue;
+    execute(pending);
+    pending = next;
+    hasPending = hasNext;
+  }
+  flushDirty();
+  _done.store(_head, std::memory_order_release);
+}
+
+void RenderQueue::renderTask(void *parameter) {
+  RenderQueue *queue = (RenderQueue *)parameter;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    queue->drain();
+  }
+}
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <OpenFontRender.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "ShadowFrame.h"
+
+// commands in flight, must be a power of two
+#define RENDER_QUEUE_CAPACITY 64
+#define RENDER_TEXT_LENGTH 40
+// areas to flush per batch, more are merged into their neighbors
+#define RENDER_MAX_DIRTY_RECTS 8
+
+// runs on the display task, may draw to the canvas and call RenderQueue::invalidate()
+typedef void (*RenderPainter)(void *context);
+
+typedef enum RenderOp : uint8_t {
+  RENDER_FILL,
+  // centered on x/y like OpenFontRender::cdrawString()
+  RENDER_TEXT,
+  RENDER_PAINT,
+  RENDER_FLUSH
+} RenderOp;
+
+typedef struct RenderRect {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+} RenderRect;
+
+typedef struct RenderCommand {
+  RenderOp op;
+  uint8_t fontSize;
+  uint16_t color;
+  RenderRect rect;
+  RenderPainter painter;
+  void *context;
+  char text[RENDER_TEXT_LENGTH];
+} RenderCommand;
+
+/**
+ * Draw commands from any task, executed in order by the display task which owns the shadow frame
+ * and thereby SPI.
+ *
+ * Producers only copy their command into a bounded lock-free ring (multiple producers, one
+ * consumer) and notify the display task. They never wait for drawing or SPI, only for a free slot
+ * if the ring is full. The display task takes everything that's queued as one batch, merges
+ * adjacent commands (repeated paints, fills that line up) and collects the areas to flush. Once
+ * the batch is drawn, the coalesced areas are flushed, i.e. the changed tiles are pushed in as few
+ * window transactions as possible.
+ *
+ * If the display task can't be started, the posting task draws its command (and whatever is queued
+ * before it) itself, one task at a time.
+ */
+class RenderQueue {
+public:
+  RenderQueue(ShadowFrame *frame, OpenFontRender *ofr);
+  // starts the display task, nothing is drawn before; false if commands are drawn synchronously
+  bool begin(BaseType_t core);
+  void fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  // longer texts are truncated to RENDER_TEXT_LENGTH - 1 characters
+  void text(const char *text, int16_t x, int16_t y, uint8_t fontSize);
+  void paint(RenderPainter painter, void *context = nullptr);
+  void flush(int16_t x, int16_t y, int16_t w, int16_t h);
+  // blocks until all commands posted so far are on the display, e.g. before light sleep
+  void wait();
+  // display task only, e.g. from a painter: the area is flushed once the batch is drawn
+  void invalidate(int16_t x, int16_t y, int16_t w, int16_t h);
+  // display task only, see ShadowFrame::surface()
+  TFT_eSPI *canvas();
+
+private:
+  typedef struct Cell {
+    // position + 1 once the command is written, position + capacity once it's taken
+    std::atomic<uint32_t> sequence;
+    RenderCommand command;
+  } Cell;
+
+  ShadowFrame *_frame;
+  OpenFontRender *_ofr;
+  Cell _cells[RENDER_QUEUE_CAPACITY];
+  // next position to claim, shared by the producers
+  std::atomic<uint32_t> _tail;
+  // next position to take, display task only
+  uint32_t _head = 0;
+  // commands executed and flushed
+  std::atomic<uint32_t> _done;
+  TaskHandle_t _task = nullptr;
+  // no display task, producers take turns as the consumer
+  bool _synchronous = false;
+  SemaphoreHandle_t _lock = nullptr;
+  RenderRect _dirty[RENDER_MAX_DIRTY_RECTS];
+  uint8_t _dirtyCount = 0;
+
+  void post(const RenderCommand &command);
+  bool take(RenderCommand *command);
+  bool merge(RenderCommand *pending, const RenderCommand &next);
+  void execute(const RenderCommand &command);
+  void flushDirty();
+  void drain();
+  static void renderTask(void *parameter);
+};
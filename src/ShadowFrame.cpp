@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "ShadowFrame.h"
+
+// tiles pushed through the blitter at once, limited by the size of its buffers
+#define SHADOW_MAX_BLIT_COLUMNS (BLIT_BUFFER_PIXELS / (SHADOW_TILE_SIZE * SHADOW_TILE_SIZE))
+
+ShadowFrame::ShadowFrame(TFT_eSPI *tft) : _frame(tft) {
+  _tft = tft;
+}
+
+bool ShadowFrame::begin() {
+  // the tiles must cover the display exactly, which they do for 320x480 in either orientation
+  _columns = _tft->width() / SHADOW_TILE_SIZE;
+  _rows = _tft->height() / SHADOW_TILE_SIZE;
+  _tileHashes = (uint32_t *)calloc(_columns * _rows, sizeof(uint32_t));
+  // sprites go to PSRAM if there is some
+  if (_tileHashes == nullptr || _frame.createSprite(_tft->width(), _tft->height()) == nullptr) {
+    log_e("Failed to allocate the shadow frame, not enough PSRAM.");
+    // flush() does nothing then
+    free(_tileHashes);
+    _tileHashes = nullptr;
+    return false;
+  }
+  _frame.setSwapBytes(false);
+  _frame.fillSprite(TFT_BLACK);
+  invalidate();
+  return true;
+}
+
+TFT_eSprite *ShadowFrame::canvas() {
+  return _tileHashes != nullptr ? &_frame : nullptr;
+}
+
+TFT_eSPI *ShadowFrame::surface() {
+  return _tileHashes != nullptr ? (TFT_eSPI *)&_frame : _tft;
+}
+
+uint32_t ShadowFrame::flush() {
+  return flush(0, 0, _tft->width(), _tft->height());
+}
+
+uint32_t ShadowFrame::flush(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (_tileHashes == nullptr) return 0;
+  unsigned long startMicros = micros();
+  uint16_t firstColumn = max(0, x / SHADOW_TILE_SIZE);
+  uint16_t lastColumn = min((int)_columns, (x + w + SHADOW_TILE_SIZE - 1) / SHADOW_TILE_SIZE);
+  uint16_t firstRow = max(0, y / SHADOW_TILE_SIZE);
+  uint16_t lastRow = min((int)_rows, (y + h + SHADOW_TILE_SIZE - 1) / SHADOW_TILE_SIZE);
+
+  // the blitter runs its own transactions, otherwise the tiles are pushed in one from here
+  if (_blitter == nullptr) {
+    _tft->startWrite();
+    if (_writeFrequency > 0) _tft->getSPIinstance().setFrequency(_writeFrequency);
+  }
+  uint32_t changedTiles = 0;
+  for (uint16_t row = firstRow; row < lastRow; row++) {
+    // runs of changed tiles next to each other are pushed together
+    int16_t runStart = -1;
+    for (uint16_t column = firstColumn; column <= lastColumn; column++) {
+      bool changed = false;
+      if (column < lastColumn) {
+        uint32_t hash = hashTile(column, row);
+        uint32_t *lastHash = &_tileHashes[row * _columns + column];
+        changed = hash != *lastHash;
+        *lastHash = hash;
+      }
+      if (changed) {
+        changedTiles++;
+        if (runStart < 0) runStart = column;
+        if (column + 1 - runStart == SHADOW_MAX_BLIT_COLUMNS) {
+          pushTiles(runStart, column + 1 - runStart, row);
+          runStart = -1;
+        }
+      } else if (runStart >= 0) {
+        pushTiles(runStart, column - runStart, row);
+        runStart = -1;
+      }
+    }
+  }
+  if (_blitter != nullptr) {
+    _blitter->wait();
+  } else {
+    _tft->endWrite();
+  }
+
+  uint32_t bytes = changedTiles * SHADOW_TILE_SIZE * SHADOW_TILE_SIZE * 2;
+  _bytesPushed += bytes;
+  log_d("Flushed %u tiles (%u bytes) in %lu us.", changedTiles, bytes, micros() - startMicros);
+  return bytes;
+}
+
+uint32_t ShadowFrame::bytesPushed() {
+  return _bytesPushed;
+}
+
+void ShadowFrame::invalidate() {
+  if (_tileHashes == nullptr) return;
+  // a hash can't tell a tile has never been pushed, the inverted one of the current content can
+  for (uint16_t row = 0; row < _rows; row++) {
+    for (uint16_t column = 0; column < _columns; column++) {
+      _tileHashes[row * _columns + column] = ~hashTile(column, row);
+    }
+  }
+}
+
+void ShadowFrame::setBlitter(AsyncBlitter *blitter) {
+  _blitter = blitter;
+}
+
+void ShadowFrame::setWriteFrequency(uint32_t frequency) {
+  _writeFrequency = frequency;
+}
+
+// Word-wise multiplicative hash over the 16 rows of the tile, two pixels per 32bit word.
+uint32_t ShadowFrame::hashTile(uint16_t column, uint16_t row) {
+  const uint32_t *line = (const uint32_t *)((uint16_t *)_frame.getPointer() +
+                                            row * SHADOW_TILE_SIZE * _frame.width() +
+                                            column * SHADOW_TILE_SIZE);
+  uint16_t stride = _frame.width() / 2;
+  uint32_t hash = 0x811C9DC5;
+  for (uint8_t y = 0; y < SHADOW_TILE_SIZE; y++, line += stride) {
+    for (uint8_t i = 0; i < SHADOW_TILE_SIZE / 2; i++) {
+      hash = (hash ^ line[i]) * 0x9E3779B1;
+      hash ^= hash >> 15;
+    }
+  }
+  return hash;
+}
+
+void ShadowFrame::pushTiles(uint16_t firstColumn, uint16_t columns, uint16_t row) {
+  int32_t x = firstColumn * SHADOW_TILE_SIZE;
+  int32_t y = row * SHADOW_TILE_SIZE;
+  uint16_t w = columns * SHADOW_TILE_SIZE;
+  uint16_t *pixels = _blitter != nullptr ? _blitter->reserve(x, y, w, SHADOW_TILE_SIZE) : nullptr;
+  if (pixels == nullptr) {
+    _frame.pushSprite(x, y, x, y, w, SHADOW_TILE_SIZE);
+    return;
+  }
+
+  // the blitter expects the pixels not byte-swapped, tiles are 32bit aligned
+  const uint32_t *src =
+    (const uint32_t *)((uint16_t *)_frame.getPointer() + y * _frame.width() + x);
+  uint32_t *dst = (uint32_t *)pixels;
+  for (uint8_t line = 0; line < SHADOW_TILE_SIZE; line++, src += _frame.width() / 2) {
+    for (uint16_t i = 0; i < w / 2; i++) {
+      *dst++ = ((src[i] & 0x00FF00FF) << 8) | ((src[i] >> 8) & 0x00FF00FF);
+    }
+  }
+}
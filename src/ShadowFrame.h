@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <TFT_eSPI.h>
+
+#include "AsyncBlitter.h"
+
+// edge length of the square tiles the frame is compared in
+#define SHADOW_TILE_SIZE 16
+
+/**
+ * Full-frame RGB565 shadow of the display in PSRAM (300KB at 320x480) which all drawing goes to.
+ *
+ * flush() hashes the frame in tiles of SHADOW_TILE_SIZE x SHADOW_TILE_SIZE pixels and only pushes
+ * the tiles whose hash changed since they were last pushed. Redrawing the clock or a few numbers
+ * thus costs a few KB over SPI rather than the whole frame, and since nothing is drawn to the
+ * display directly anymore, there's no flicker from clearing areas before redrawing them.
+ */
+class ShadowFrame {
+public:
+  ShadowFrame(TFT_eSPI *tft);
+  // allocates the frame at the current size of the display, false if there's not enough PSRAM
+  bool begin();
+  // the sprite to draw to, nullptr if begin() failed; it stores the pixels byte-swapped in display
+  // order, native RGB565 must be pushed to it with setSwapBytes(true)
+  TFT_eSprite *canvas();
+  // the canvas, or the display itself if there's no frame: drawing still works, just unbuffered
+  TFT_eSPI *surface();
+  /**
+   * Pushes the tiles that changed, within the given area only if there is one.
+   *
+   * @return bytes of pixel data pushed
+   */
+  uint32_t flush();
+  uint32_t flush(int16_t x, int16_t y, int16_t w, int16_t h);
+  // bytes of pixel data pushed by all flushes so far
+  uint32_t bytesPushed();
+  // the next flush() pushes all tiles, e.g. after something was drawn to the display directly
+  void invalidate();
+  // pushes changed tiles through the blitter, hashing continues while they're sent
+  void setBlitter(AsyncBlitter *blitter);
+  // SPI clock for pushing tiles without the blitter, 0 keeps SPI_FREQUENCY
+  void setWriteFrequency(uint32_t frequency);
+
+private:
+  TFT_eSPI *_tft;
+  TFT_eSprite _frame;
+  AsyncBlitter *_blitter = nullptr;
+  uint32_t _writeFrequency = 0;
+  uint32_t _bytesPushed = 0;
+  // hash of every tile as last pushed, row by row
+  uint32_t *_tileHashes = nullptr;
+  uint16_t _columns = 0;
+  uint16_t _rows = 0;
+
+  uint32_t hashTile(uint16_t column, uint16_t row);
+  void pushTiles(uint16_t firstColumn, uint16_t columns, uint16_t row);
+};
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#include "WeatherClient.h"
+
+#include <HTTPClient.h>
+#include <JsonStreamingParser.h>
+
+#define WEATHER_CLIENT_API_URL "http://api.openweathermap.org/data/2.5/"
+// gives up on a response that stalls for this long
+#define WEATHER_CLIENT_TIMEOUT_MILLIS 10000
+
+void WeatherClient::setLanguage(const String &language) {
+  _language = language;
+}
+
+void WeatherClient::setAllowedHours(const uint8_t *hours, uint8_t count) {
+  _allowedHours = hours;
+  _allowedHoursCount = count;
+}
+
+FetchResult WeatherClient::updateCurrent(WeatherSnapshot *snapshot, const String &appId,
+                                         const char *locationId, HttpCacheState *cache,
+                                         uint32_t observationTime) {
+  _snapshot = snapshot;
+  _forecast = false;
+  _knownObservationTime = observationTime;
+  return fetch(WEATHER_CLIENT_API_URL "weather?id=" + String(locationId) + "&appid=" + appId +
+               "&units=metric&lang=" + _language, cache);
+}
+
+FetchResult WeatherClient::updateForecasts(WeatherSnapshot *snapshot, const String &appId,
+                                           const char *locationId, HttpCacheState *cache) {
+  _snapshot = snapshot;
+  _forecast = true;
+  _knownObservationTime = 0;
+  _snapshot->forecastCount = 0;
+  return fetch(WEATHER_CLIENT_API_URL "forecast?id=" + String(locationId) + "&appid=" + appId +
+               "&units=metric&lang=" + _language, cache);
+}
+
+FetchResult WeatherClient::fetch(const String &url, HttpCacheState *cache) {
+  HTTPClient http;
+  // rules out chunked transfer encoding which would end up in the parser
+  http.useHTTP10(true);
+  http.begin(url);
+  const char *headers[] = {"ETag", "Last-Modified", "Cache-Control"};
+  http.collectHeaders(headers, sizeof(headers) / sizeof(headers[0]));
+  if (cache->etag[0] != 0) http.addHeader("If-None-Match", cache->etag);
+  if (cache->lastModified[0] != 0) http.addHeader("If-Modified-Since", cache->lastModified);
+  int status = http.GET();
+  if (status == HTTP_CODE_NOT_MODIFIED) {
+    cache->maxAgeSeconds = parseMaxAge(http.header("Cache-Control"));
+    http.end();
+    return FETCH_NOT_MODIFIED;
+  }
+  if (status != HTTP_CODE_OK) {
+    log_e("OpenWeatherMap request failed: %d", status);
+    http.end();
+    return FETCH_FAILED;
+  }
+  // only stored once the response made it into the snapshot
+  String etag = http.header("ETag");
+  String lastModified = http.header("Last-Modified");
+  uint32_t maxAgeSeconds = parseMaxAge(http.header("Cache-Control"));
+
+  JsonStreamingParser parser;
+  parser.setListener(this);
+  _key = "";
+  _depth = 0;
+  _weatherEntries = 0;
+  _complete = false;
+  _unchanged = false;
+  WiFiClient *stream = http.getStreamPtr();
+  uint8_t buffer[128];
+  unsigned long lastDataMillis = millis();
+  while ((http.connected() || stream->available() > 0) && !_complete && !_unchanged) {
+    int available = stream->available();
+    if (available <= 0) {
+      if (millis() - lastDataMillis > WEATHER_CLIENT_TIMEOUT_MILLIS) break;
+      delay(1);
+      continue;
+    }
+    size_t length = stream->readBytes(buffer, min(available, (int)sizeof(buffer)));
+    for (size_t i = 0; i < length; i++) {
+      parser.parse(buffer[i]);
+    }
+    lastDataMillis = millis();
+  }
+  http.end();
+
+  if (!_complete && !_unchanged) {
+    log_e("OpenWeatherMap response incomplete.");
+    return FETCH_FAILED;
+  }
+  strlcpy(cache->etag, etag.c_str(), sizeof(cache->etag));
+  strlcpy(cache->lastModified, lastModified.c_str(), sizeof(cache->lastModified));
+  cache->maxAgeSeconds = maxAgeSeconds;
+  return _unchanged ? FETCH_NOT_MODIFIED : FETCH_UPDATED;
+}
+
+// max-age of a Cache-Control header, 0 if there's none
+uint32_t WeatherClient::parseMaxAge(const String &cacheControl) {
+  int start = cacheControl.indexOf("max-age=");
+  if (start < 0) return 0;
+  long maxAge = cacheControl.substring(start + 8).toInt();
+  return maxAge > 0 ? maxAge : 0;
+}
+
+// The key of the innermost object or array that has one, "" at the root.
+const String &WeatherClient::parent() {
+  static const String root = "";
+  for (int8_t i = min(_depth, (uint8_t)WEATHER_CLIENT_MAX_DEPTH) - 1; i >= 0; i--) {
+    if (_parents[i].length() > 0) return _parents[i];
+  }
+  return root;
+}
+
+bool WeatherClient::isAllowedHour(uint32_t timestamp) {
+  if (_allowedHours == nullptr) return true;
+  uint8_t hour = timestamp % 86400 / 3600;
+  for (uint8_t i = 0; i < _allowedHoursCount; i++) {
+    if (_allowedHours[i] == hour) return true;
+  }
+  return false;
+}
+
+void WeatherClient::whitespace(char c) {
+}
+
+void WeatherClient::startDocument() {
+}
+
+void WeatherClient::key(String key) {
+  _key = key;
+}
+
+void WeatherClient::value(String value) {
+  const String &parentKey = parent();
+  if (_forecast) {
+    forecastValue(parentKey, value);
+  } else {
+    currentValue(parentKey, value);
+  }
+  _key = "";
+}
+
+void WeatherClient::currentValue(const String &parent, const String &value) {
+  CurrentRecord *current = &_snapshot->current;
+  if (parent == "coord") {
+    if (_key == "lat") current->lat = value.toFloat();
+    else if (_key == "lon") current->lon = value.toFloat();
+  } else if (parent == "weather") {
+    if (_weatherEntries != 1) return;
+    if (_key == "id") current->condition = conditionIndex(value.toInt());
+    else if (_key == "description") {
+      copyUtf8(current->description, value.c_str(), sizeof(current->description));
+    }
+  } else if (parent == "main") {
+    if (_key == "temp") current->temp = toHundredths(value.toFloat());
+    else if (_key == "feels_like") current->feelsLike = toHundredths(value.toFloat());
+    else if (_key == "pressure") current->pressure = value.toInt();
+    else if (_key == "humidity") current->humidity = value.toInt();
+  } else if (parent == "wind") {
+    if (_key == "speed") current->windSpeed = toHundredths(value.toFloat());
+    else if (_key == "deg") current->windDeg = value.toInt();
+  } else if (parent == "sys") {
+    if (_key == "sunrise") current->sunrise = value.toInt();
+    else if (_key == "sunset") current->sunset = value.toInt();
+  } else if (parent.length() == 0 && _key == "dt") {
+    current->observationTime = value.toInt();
+    // the rest of the response is what there is already
+    _unchanged = current->observationTime == _knownObservationTime;
+  }
+}
+
+void WeatherClient::forecastValue(const String &parent, const String &value) {
+  if (_snapshot->forecastCount == WEATHER_SNAPSHOT_FORECASTS) return;
+  ForecastRecord *forecast = &_snapshot->forecasts[_snapshot->forecastCount];
+  if (parent == "list") {
+    if (_key == "dt") {
+      forecast->observationTime = value.toInt();
+      _skipForecast = !isAllowedHour(forecast->observationTime);
+    } else if (_key == "pop") {
+      // a fraction from 0 to 1
+      forecast->pop = lroundf(constrain(value.toFloat(), 0.0f, 1.0f) * 100);
+    }
+  } else if (parent == "main") {
+    if (_key == "temp") forecast->temp = toHundredths(value.toFloat());
+  } else if (parent == "weather") {
+    if (_weatherEntries == 1 && _key == "id") forecast->condition = conditionIndex(value.toInt());
+  } else if (parent == "rain") {
+    if (_key == "3h") forecast->rain = toHundredths(value.toFloat());
+  }
+}
+
+void WeatherClient::startArray() {
+  if (_depth < WEATHER_CLIENT_MAX_DEPTH) _parents[_depth] = _key;
+  _depth++;
+  _key = "";
+}
+
+void WeatherClient::startObject() {
+  if (_depth < WEATHER_CLIENT_MAX_DEPTH) _parents[_depth] = _key;
+  _depth++;
+  _key = "";
+  if (_depth < 2 || _depth > WEATHER_CLIENT_MAX_DEPTH || _parents[_depth - 1].length() > 0) {
+    return;
+  }
+
+  // an entry of an array
+  const String &array = _parents[_depth - 2];
+  if (array == "weather") {
+    _weatherEntries++;
+  } else if (array == "list" && _forecast &&
+             _snapshot->forecastCount < WEATHER_SNAPSHOT_FORECASTS) {
+    ForecastRecord *forecast = &_snapshot->forecasts[_snapshot->forecastCount];
+    memset(forecast, 0, sizeof(ForecastRecord));
+    forecast->condition = WEATHER_SNAPSHOT_NONE;
+    _weatherEntries = 0;
+    _skipForecast = false;
+  }
+}
+
+void WeatherClient::endArray() {
+  if (_depth > 0) _depth--;
+}
+
+void WeatherClient::endObject() {
+  if (_depth == 0) return;
+  if (_forecast && _depth >= 2 && _depth <= WEATHER_CLIENT_MAX_DEPTH &&
+      _parents[_depth - 1].length() == 0 && _parents[_depth - 2] == "list" &&
+      !_skipForecast && _snapshot->forecastCount < WEATHER_SNAPSHOT_FORECASTS) {
+    _snapshot->forecastCount++;
+  }
+  _depth--;
+  if (_depth == 0) _complete = true;
+}
+
+void WeatherClient::endDocument() {
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <JsonListener.h>
+
+#include "WeatherSnapshot.h"
+
+// deepest nesting of the OpenWeatherMap responses is 5: root, list, entry, weather, entry
+#define WEATHER_CLIENT_MAX_DEPTH 6
+#define WEATHER_CLIENT_ETAG_LENGTH 64
+#define WEATHER_CLIENT_DATE_LENGTH 32
+
+typedef enum FetchResult {
+  FETCH_FAILED,
+  // 304 or the same observation time as before, the snapshot wasn't touched or is incomplete
+  FETCH_NOT_MODIFIED,
+  FETCH_UPDATED
+} FetchResult;
+
+// Validators of the last response to an endpoint, sent along with the next request to it.
+typedef struct HttpCacheState {
+  char etag[WEATHER_CLIENT_ETAG_LENGTH];
+  char lastModified[WEATHER_CLIENT_DATE_LENGTH];
+  // from Cache-Control, 0 if there was none
+  uint32_t maxAgeSeconds;
+} HttpCacheState;
+
+/**
+ * Fetches current weather and forecasts from OpenWeatherMap and streams the responses straight
+ * into a WeatherSnapshot, without intermediate containers or a DOM. Always in metric units, see
+ * toHundredths().
+ *
+ * Replaces OpenWeatherMapCurrent and OpenWeatherMapForecast of the ThingPulse weather library which
+ * fill containers with a String per field.
+ */
+class WeatherClient : public JsonListener {
+public:
+  void setLanguage(const String &language);
+  // forecasts for other hours (UTC) are skipped, all are kept by default
+  void setAllowedHours(const uint8_t *hours, uint8_t count);
+  /**
+   * Update the current weather or the forecasts of the snapshot, the other part stays as it is.
+   * Requests are conditional on the validators in cache which are updated with the response.
+   *
+   * @param observationTime of the current weather there is already, parsing stops once the
+   *        response turns out to have the same
+   * @return the snapshot may be partially updated unless FETCH_UPDATED
+   */
+  FetchResult updateCurrent(WeatherSnapshot *snapshot, const String &appId,
+                            const char *locationId, HttpCacheState *cache,
+                            uint32_t observationTime);
+  FetchResult updateForecasts(WeatherSnapshot *snapshot, const String &appId,
+                              const char *locationId, HttpCacheState *cache);
+
+  void whitespace(char c) override;
+  void startDocument() override;
+  void key(String key) override;
+  void value(String value) override;
+  void endArray() override;
+  void endObject() override;
+  void endDocument() override;
+  void startArray() override;
+  void startObject() override;
+
+private:
+  String _language = "en";
+  const uint8_t *_allowedHours = nullptr;
+  uint8_t _allowedHoursCount = 0;
+
+  WeatherSnapshot *_snapshot = nullptr;
+  bool _forecast = false;
+  String _key;
+  // the key each open object or array was found at, "" for array entries
+  String _parents[WEATHER_CLIENT_MAX_DEPTH];
+  uint8_t _depth = 0;
+  // only the first entry of each "weather" array is used
+  uint8_t _weatherEntries = 0;
+  bool _skipForecast = false;
+  uint32_t _knownObservationTime = 0;
+  // the root object has been closed
+  bool _complete = false;
+  bool _unchanged = false;
+
+  FetchResult fetch(const String &url, HttpCacheState *cache);
+  const String &parent();
+  uint32_t parseMaxAge(const String &cacheControl);
+  bool isAllowedHour(uint32_t timestamp);
+  void currentValue(const String &parent, const String &value);
+  void forecastValue(const String &parent, const String &value);
+};
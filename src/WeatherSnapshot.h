@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Arduino.h>
+
+// bump whenever the layout of WeatherSnapshot changes, persisted snapshots of other versions are
+// discarded
+#define WEATHER_SNAPSHOT_VERSION 4
+// 5 day / 3 hour forecast data => 8 forecasts/day => 40 total
+#define WEATHER_SNAPSHOT_FORECASTS 40
+// bytes of UTF-8 incl. the terminator, the longest descriptions OpenWeatherMap has (e.g. Russian
+// or Ukrainian with 2 bytes per letter) are around 50
+#define WEATHER_SNAPSHOT_DESCRIPTION_LENGTH 64
+// marks an unknown condition
+#define WEATHER_SNAPSHOT_NONE 0xFF
+
+// all codes OpenWeatherMap documents: https://openweathermap.org/weather-conditions
+constexpr uint16_t OWM_CONDITION_CODES[] = {
+  200, 201, 202, 210, 211, 212, 221, 230, 231, 232,
+  300, 301, 302, 310, 311, 312, 313, 314, 321,
+  500, 501, 502, 503, 504, 511, 520, 521, 522, 531,
+  600, 601, 602, 611, 612, 613, 615, 616, 620, 621, 622,
+  701, 711, 721, 731, 741, 751, 761, 762, 771, 781,
+  800, 801, 802, 803, 804
+};
+constexpr uint8_t OWM_CONDITION_COUNT =
+    sizeof(OWM_CONDITION_CODES) / sizeof(OWM_CONDITION_CODES[0]);
+
+// Interns an OpenWeatherMap condition code as its index in OWM_CONDITION_CODES.
+constexpr uint8_t conditionIndex(uint16_t code, uint8_t index = 0) {
+  return index == OWM_CONDITION_COUNT ? WEATHER_SNAPSHOT_NONE
+         : OWM_CONDITION_CODES[index] == code ? index
+         : conditionIndex(code, index + 1);
+}
+
+// 0 for unknown conditions
+constexpr uint16_t conditionCode(uint8_t index) {
+  return index < OWM_CONDITION_COUNT ? OWM_CONDITION_CODES[index] : 0;
+}
+
+// Temperatures (°C), wind speeds (m/s) and precipitation (mm) are stored in hundredths of the
+// metric units, switching to imperial units only changes what's displayed.
+inline int32_t toHundredths(float value) {
+  return lroundf(value * 100);
+}
+
+constexpr float fromHundredths(int32_t value) {
+  return value / 100.0f;
+}
+
+// °C as displayed, °F for imperial units
+constexpr float displayTemperature(float celsius, bool metric) {
+  return metric ? celsius : celsius * 9 / 5 + 32;
+}
+
+// m/s as displayed, mph for imperial units
+constexpr float displaySpeed(float metersPerSecond, bool metric) {
+  return metric ? metersPerSecond : metersPerSecond * 2.23694f;
+}
+
+typedef struct __attribute__((packed)) CurrentRecord {
+  float lat;
+  float lon;
+  uint32_t observationTime;
+  uint32_t sunrise;
+  uint32_t sunset;
+  int16_t temp;
+  int16_t feelsLike;
+  uint16_t windSpeed;
+  uint16_t windDeg;
+  // hPa
+  uint16_t pressure;
+  // %
+  uint8_t humidity;
+  uint8_t condition;
+  // "" if there was none
+  char description[WEATHER_SNAPSHOT_DESCRIPTION_LENGTH];
+} CurrentRecord;
+
+// Only what's displayed, i.e. no descriptions.
+typedef struct __attribute__((packed)) ForecastRecord {
+  uint32_t observationTime;
+  int16_t temp;
+  // mm within the 3h
+  uint16_t rain;
+  // probability of precipitation in percent
+  uint8_t pop;
+  uint8_t condition;
+} ForecastRecord;
+
+/**
+ * Current weather and forecasts of a location, fixed size and without pointers (~500 bytes rather
+ * than several KB of OpenWeatherMap containers plus their Strings). Conditions are indexes into
+ * OWM_CONDITION_CODES. The same bytes are persisted and copied between tasks.
+ */
+typedef struct __attribute__((packed)) WeatherSnapshot {
+  uint8_t version;
+  uint8_t forecastCount;
+  CurrentRecord current;
+  ForecastRecord forecasts[WEATHER_SNAPSHOT_FORECASTS];
+} WeatherSnapshot;
+
+inline void clearSnapshot(WeatherSnapshot *snapshot) {
+  memset(snapshot, 0, sizeof(WeatherSnapshot));
+  snapshot->version = WEATHER_SNAPSHOT_VERSION;
+  snapshot->current.condition = WEATHER_SNAPSHOT_NONE;
+}
+
+inline bool isSnapshotValid(const WeatherSnapshot *snapshot) {
+  return snapshot->version == WEATHER_SNAPSHOT_VERSION &&
+         snapshot->forecastCount <= WEATHER_SNAPSHOT_FORECASTS &&
+         memchr(snapshot->current.description, 0, WEATHER_SNAPSHOT_DESCRIPTION_LENGTH) != nullptr;
+}
+
+/**
+ * Copies the text, truncated to size - 1 bytes if need be but never within a UTF-8 sequence: half
+ * a character would come out as garbage on the display.
+ */
+inline void copyUtf8(char *to, const char *from, size_t size) {
+  if (strlcpy(to, from, size) < size) return;
+  // the first byte that didn't fit, continuation bytes (10xxxxxx) belong to the one before
+  size_t end = size - 1;
+  while (end > 0 && ((uint8_t)from[end] & 0xC0) == 0x80) end--;
+  to[end] = 0;
+}
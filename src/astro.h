@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <LittleFS.h>
+#include <SunMoonCalc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "settings.h"
+#include "util.h"
+
+#define ASTRO_TABLE_FILE "/astro.bin"
+// bump whenever the layout of AstroTable changes, persisted tables of other versions are discarded
+#define ASTRO_TABLE_VERSION 1
+// ~100m, anything closer is considered the same location
+#define ASTRO_COORDINATE_TOLERANCE 0.001
+#define ASTRO_MOON_PHASE_COUNT (sizeof(MOON_PHASES) / sizeof(MOON_PHASES[0]))
+
+typedef struct AstroDay {
+  // local noon of the day, the timestamp the values were calculated for
+  time_t date;
+  time_t sunRise;
+  time_t sunSet;
+  time_t moonRise;
+  time_t moonSet;
+  float moonAge;
+  float moonIllumination;
+  uint8_t moonPhaseIndex;
+} AstroDay;
+
+typedef struct AstroTable {
+  uint16_t version;
+  uint8_t count;
+  // local calendar day of days[0], in days since epoch
+  int32_t firstDay;
+  float lat;
+  float lon;
+  AstroDay days[NUMBER_OF_ASTRO_DAYS];
+} AstroTable;
+
+// one per location, persisted together
+AstroTable astroTables[LOCATION_COUNT];
+bool astroTableLoaded = false;
+// the loop (backlight) and the display task (drawAstro) both look up days
+SemaphoreHandle_t astroMutex = nullptr;
+
+AstroTable *findAstroTable(float lat, float lon);
+bool isAstroTableSane(const AstroTable *table);
+bool isAstroTableAt(const AstroTable *table, float lat, float lon);
+bool isAstroTableValidFor(const AstroTable *table, int32_t day, float lat, float lon);
+void loadAstroTable();
+int32_t localDayNumber(time_t timestamp);
+void saveAstroTable();
+void updateAstroTable(AstroTable *table, time_t now, float lat, float lon);
+
+void initAstro() {
+  astroMutex = xSemaphoreCreateMutex();
+}
+
+/**
+ * Sun and moon data hardly change during a day at a fixed location. Hence, the numerical solution
+ * of SunMoonCalc is run once for NUMBER_OF_ASTRO_DAYS days in a batch and persisted to the file
+ * system, one table per location. It's only recalculated once the date moves past the table.
+ *
+ * @param now current UTC timestamp
+ * @param day rise/set/phase data for the local day of now, a copy since the table may be updated
+ *        by another task
+ * @return false if the clock isn't set yet, a table for 1970 would be of no use, or if the
+ *         timezone changed meanwhile
+ */
+bool getAstroDay(time_t now, float lat, float lon, AstroDay *day) {
+  if (now < LOCAL_CLOCK_MIN_VALID) return false;
+  int32_t today = localDayNumber(now);
+  xSemaphoreTake(astroMutex, portMAX_DELAY);
+  if (!astroTableLoaded) {
+    loadAstroTable();
+    astroTableLoaded = true;
+  }
+  AstroTable *table = findAstroTable(lat, lon);
+  if (!isAstroTableValidFor(table, today, lat, lon)) {
+    updateAstroTable(table, now, lat, lon);
+    saveAstroTable();
+  }
+  // a timezone change in between may have put today outside the fresh table, skip this once
+  bool found = isAstroTableValidFor(table, today, lat, lon);
+  if (found) *day = table->days[today - table->firstDay];
+  xSemaphoreGive(astroMutex);
+  return found;
+}
+
+// The tables hold local days, another timezone shifts them. They're recalculated when next needed.
+void resetAstroTables() {
+  xSemaphoreTake(astroMutex, portMAX_DELAY);
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) astroTables[i].version = 0;
+  // the persisted ones are outdated as well
+  astroTableLoaded = true;
+  xSemaphoreGive(astroMutex);
+}
+
+/**
+ * The moon ages at a constant rate, so interpolating from the daily value is precise enough for a
+ * per-minute update and a lot cheaper than running SunMoonCalc.
+ *
+ * @return moon age in days (0 - LUNAR_MONTH) at the given timestamp
+ */
+float getMoonAge(const AstroDay *day, time_t now) {
+  float age = day->moonAge + (now - day->date) / 86400.0;
+  age = fmod(age, LUNAR_MONTH);
+  return age < 0 ? age + LUNAR_MONTH : age;
+}
+
+// The table of the location, otherwise the one that's been updated the longest time ago.
+AstroTable *findAstroTable(float lat, float lon) {
+  AstroTable *oldest = &astroTables[0];
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    AstroTable *table = &astroTables[i];
+    if (isAstroTableAt(table, lat, lon)) return table;
+    if (table->version != ASTRO_TABLE_VERSION) {
+      oldest = table;
+    } else if (oldest->version == ASTRO_TABLE_VERSION && table->firstDay < oldest->firstDay) {
+      oldest = table;
+    }
+  }
+  return oldest;
+}
+
+bool isAstroTableAt(const AstroTable *table, float lat, float lon) {
+  return table->version == ASTRO_TABLE_VERSION &&
+         fabs(table->lat - lat) < ASTRO_COORDINATE_TOLERANCE &&
+         fabs(table->lon - lon) < ASTRO_COORDINATE_TOLERANCE;
+}
+
+bool isAstroTableValidFor(const AstroTable *table, int32_t day, float lat, float lon) {
+  return isAstroTableAt(table, lat, lon) &&
+         table->count == NUMBER_OF_ASTRO_DAYS &&
+         day >= table->firstDay &&
+         day < table->firstDay + table->count;
+}
+
+void loadAstroTable() {
+  if (!LittleFS.exists(ASTRO_TABLE_FILE)) return;
+
+  File file = LittleFS.open(ASTRO_TABLE_FILE, "r");
+  // a different number of locations changes the size, too
+  if (file.size() != sizeof(astroTables) ||
+      file.read((uint8_t *)astroTables, sizeof(astroTables)) != sizeof(astroTables)) {
+    log_w("Discarding astro table with unexpected size %d.", file.size());
+    for (uint8_t i = 0; i < LOCATION_COUNT; i++) astroTables[i].version = 0;
+  }
+  file.close();
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    if (astroTables[i].version == ASTRO_TABLE_VERSION && !isAstroTableSane(&astroTables[i])) {
+      log_w("Discarding corrupt astro table %d.", i);
+      astroTables[i].version = 0;
+    }
+  }
+}
+
+// Values that index arrays must be in range, whatever the file said.
+bool isAstroTableSane(const AstroTable *table) {
+  if (table->count > NUMBER_OF_ASTRO_DAYS) return false;
+  for (uint8_t i = 0; i < table->count; i++) {
+    if (table->days[i].moonPhaseIndex >= ASTRO_MOON_PHASE_COUNT) return false;
+  }
+  return true;
+}
+
+int32_t localDayNumber(time_t timestamp) {
+  struct tm local;
+  struct tm *localTime = toLocalTime(timestamp, &local);
+  return days_from_epoch(localTime->tm_year + 1900, localTime->tm_mon + 1, localTime->tm_mday);
+}
+
+void saveAstroTable() {
+  File file = LittleFS.open(ASTRO_TABLE_FILE, "w");
+  if (!file || file.write((uint8_t *)astroTables, sizeof(astroTables)) != sizeof(astroTables)) {
+    log_e("Failed to persist astro table.");
+  }
+  file.close();
+}
+
+void updateAstroTable(AstroTable *table, time_t now, float lat, float lon) {
+  unsigned long startMillis = millis();
+  struct tm noon;
+  toLocalTime(now, &noon);
+  noon.tm_hour = 12;
+  noon.tm_min = 0;
+  noon.tm_sec = 0;
+  noon.tm_isdst = -1;
+
+  table->version = ASTRO_TABLE_VERSION;
+  table->count = NUMBER_OF_ASTRO_DAYS;
+  table->firstDay = localDayNumber(now);
+  table->lat = lat;
+  table->lon = lon;
+
+  for (uint8_t i = 0; i < NUMBER_OF_ASTRO_DAYS; i++) {
+    struct tm dayNoon = noon;
+    // mktime() normalizes the day overflow into the next month/year as well as DST changes
+    dayNoon.tm_mday += i;
+    time_t date = mktime(&dayNoon);
+
+    SunMoonCalc smCalc = SunMoonCalc(date, lat, lon);
+    const SunMoonCalc::Result result = smCalc.calculateSunAndMoonData();
+
+    AstroDay *day = &table->days[i];
+    day->date = date;
+    day->sunRise = result.sun.rise;
+    day->sunSet = result.sun.set;
+    day->moonRise = result.moon.rise;
+    day->moonSet = result.moon.set;
+    day->moonAge = result.moon.age;
+    day->moonIllumination = result.moon.illumination;
+    day->moonPhaseIndex = result.moon.phase.index;
+  }
+  log_i("Calculated astro data for %d days in %lums.", NUMBER_OF_ASTRO_DAYS, millis() - startMillis);
+}
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <esp_timer.h>
+
+#include "astro.h"
+#include "display.h"
+#include "settings.h"
+
+uint8_t backlightBrightness = TFT_LED_BRIGHTNESS;
+// written by the loop, read by the fade steps in the esp_timer task
+volatile uint8_t backlightTarget = TFT_LED_BRIGHTNESS;
+uint8_t backlightFadeStep = 1;
+// a step is pending, the timer is one-shot and re-armed by the step until the target is reached
+bool backlightFading = false;
+// guards target, step and backlightFading between the loop and the fade steps
+portMUX_TYPE backlightMux = portMUX_INITIALIZER_UNLOCKED;
+esp_timer_handle_t backlightFadeTimer = nullptr;
+unsigned long lastActivityMillis = 0;
+
+void fadeBacklightTo(uint8_t brightness);
+bool isNight(time_t now, const AstroDay *today);
+void onBacklightFadeStep(void *arg);
+
+void initBacklightControl() {
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onBacklightFadeStep;
+  timerArgs.name = "backlight-fade";
+  esp_timer_create(&timerArgs, &backlightFadeTimer);
+  lastActivityMillis = millis();
+}
+
+/**
+ * The clock isn't rendered while this is false, there's nothing to see anyway.
+ */
+bool isBacklightOn() {
+  return backlightTarget > 0;
+}
+
+bool isBacklightDimmed() {
+  return backlightTarget > 0 && backlightTarget < TFT_LED_BRIGHTNESS;
+}
+
+/**
+ * Restarts the inactivity timeout, call on every touch.
+ *
+ * @return true if the display was off, i.e. the touch should only wake it up
+ */
+bool registerActivity() {
+  bool wasOff = !isBacklightOn();
+  lastActivityMillis = millis();
+  fadeBacklightTo(TFT_LED_BRIGHTNESS);
+  return wasOff;
+}
+
+/**
+ * Full brightness after recent activity, otherwise off at night and dimmed during the day. Cheap
+ * enough to be called on every clock tick.
+ *
+ * @param today sun rise/set of the current day, nullptr if not known yet
+ */
+void updateBacklight(time_t now, const AstroDay *today) {
+  if (millis() - lastActivityMillis < BACKLIGHT_DIM_AFTER_SECONDS * 1000UL) {
+    fadeBacklightTo(TFT_LED_BRIGHTNESS);
+  } else if (isNight(now, today)) {
+    fadeBacklightTo(0);
+  } else {
+    fadeBacklightTo(TFT_LED_DIMMED_BRIGHTNESS);
+  }
+}
+
+// Steps towards the target in the esp_timer task, every step is the same size so that any change
+// takes BACKLIGHT_FADE_MILLIS.
+void fadeBacklightTo(uint8_t brightness) {
+  if (brightness == backlightTarget) return;
+  portENTER_CRITICAL(&backlightMux);
+  uint8_t distance = abs(brightness - backlightBrightness);
+  backlightFadeStep = max(1, distance * BACKLIGHT_FADE_STEP_MILLIS / BACKLIGHT_FADE_MILLIS);
+  backlightTarget = brightness;
+  // a pending step picks up the new target, otherwise the fade starts over
+  bool start = !backlightFading;
+  backlightFading = true;
+  portEXIT_CRITICAL(&backlightMux);
+  log_d("Fading backlight from %d to %d.", backlightBrightness, brightness);
+  if (start) esp_timer_start_once(backlightFadeTimer, BACKLIGHT_FADE_STEP_MILLIS * 1000);
+}
+
+bool isNight(time_t now, const AstroDay *today) {
+#if defined(BACKLIGHT_OFF_BETWEEN_SUNSET_AND_SUNRISE)
+  return today != nullptr && (now < today->sunRise || now > today->sunSet);
+#elif defined(BACKLIGHT_OFF_FROM_HOUR) && defined(BACKLIGHT_OFF_UNTIL_HOUR)
+  struct tm local;
+  uint8_t hour = toLocalTime(now, &local)->tm_hour;
+  // the range may span midnight
+  if (BACKLIGHT_OFF_FROM_HOUR <= BACKLIGHT_OFF_UNTIL_HOUR) {
+    return hour >= BACKLIGHT_OFF_FROM_HOUR && hour < BACKLIGHT_OFF_UNTIL_HOUR;
+  }
+  return hour >= BACKLIGHT_OFF_FROM_HOUR || hour < BACKLIGHT_OFF_UNTIL_HOUR;
+#else
+  return false;
+#endif
+}
+
+// Deciding to stop and a new target from the loop are one critical section, so a fade can't stop
+// short of a target set meanwhile.
+void onBacklightFadeStep(void *arg) {
+  portENTER_CRITICAL(&backlightMux);
+  uint8_t target = backlightTarget;
+  if (backlightBrightness < target) {
+    backlightBrightness = min((int)target, backlightBrightness + backlightFadeStep);
+  } else if (backlightBrightness > target) {
+    backlightBrightness = max((int)target, backlightBrightness - backlightFadeStep);
+  }
+  uint8_t brightness = backlightBrightness;
+  backlightFading = brightness != target;
+  bool next = backlightFading;
+  portEXIT_CRITICAL(&backlightMux);
+  setBacklight(brightness);
+  if (next) esp_timer_start_once(backlightFadeTimer, BACKLIGHT_FADE_STEP_MILLIS * 1000);
+}
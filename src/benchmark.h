@@ -0,0 +1,462 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Only built into the "benchmark" PlatformIO environment, see platformio.ini.
+#ifdef BENCHMARK
+
+#include <SunMoonCalc.h>
+#include <TFT_eSPI.h>
+#include <sys/time.h>
+
+#include "AssetStore.h"
+#include "AsyncBlitter.h"
+#include "GfxUi.h"
+#include "ShadowFrame.h"
+#include "WeatherSnapshot.h"
+#include "benchmark_dataset.h"
+#include "config.h"
+#include "ephemeris_reference.h"
+#include "settings.h"
+#include "util.h"
+
+// number of calls timed per function for the cheap calendar functions
+#define BENCHMARK_ITERATIONS 100000
+// roughly a week, odd step so the samples wander through all hours, minutes and seconds
+#define BENCHMARK_TIMESTAMP_STEP 608443
+// times each icon is composited onto the sprite
+#define BENCHMARK_COMPOSITE_ITERATIONS 50
+// local time is checked from 2020 for this long, in steps of about 2h12m
+#define BENCHMARK_LOCAL_CLOCK_FROM 1577836800L
+#define BENCHMARK_LOCAL_CLOCK_SECONDS (10 * 365 * 86400L)
+#define BENCHMARK_LOCAL_CLOCK_STEP 7919
+// size of the large weather icons
+#define BENCHMARK_ICON_SIZE 100
+// times the set of images is drawn per blit mode
+#define BENCHMARK_BLIT_ITERATIONS 10
+// flushes timed per scenario of the shadow frame
+#define BENCHMARK_FLUSH_ITERATIONS 20
+// full frames rendered by benchmarkFrames()
+#define BENCHMARK_FRAMES 10
+// the frame benchmark results are logged as one line of JSON after this prefix, for
+// scripts/compare_benchmarks.py
+#define BENCHMARK_JSON_PREFIX "BENCHMARK_JSON "
+
+typedef struct BenchmarkWidget {
+  const char *name;
+  void (*draw)();
+  const RectangleDef *region;
+} BenchmarkWidget;
+
+typedef struct WidgetStats {
+  uint32_t micros;
+  uint32_t spiBytes;
+  uint32_t glyphs;
+  uint32_t assetReads;
+  uint32_t allocations;
+} WidgetStats;
+
+// keeps the compiler from optimizing the benchmarked calls away
+volatile int32_t benchmarkSink;
+// UTF-8 characters passed to the font renderer, see BENCHMARK_COUNT_GLYPHS
+uint32_t benchmarkGlyphs = 0;
+// calls to malloc() & co. while benchmarkCountAllocations is set, see the wrappers below
+volatile uint32_t benchmarkAllocations = 0;
+volatile bool benchmarkCountAllocations = false;
+
+#define BENCHMARK_COUNT_GLYPHS(text) benchmarkGlyphs += countGlyphs(text)
+
+void benchmarkAstro();
+unsigned long benchmarkBlitMicros(TFT_eSPI *tft, GfxUi *ui);
+void benchmarkBlitting(TFT_eSPI *tft, GfxUi *ui, AsyncBlitter *blitter);
+void benchmarkCalendar();
+void benchmarkCompositing(TFT_eSPI *tft, GfxUi *ui);
+void benchmarkLocalClock();
+void benchmarkFrames(ShadowFrame *frame, AssetStore *assets, const BenchmarkWidget *widgets,
+                     uint8_t count);
+void loadBenchmarkDataset(WeatherSnapshot *snapshot);
+uint32_t countGlyphs(const char *text);
+void freezeBenchmarkClock();
+void logFrameBenchmark(const BenchmarkWidget *widgets, const WidgetStats *stats, uint8_t count);
+void benchmarkShadowFrame(TFT_eSPI *tft, ShadowFrame *frame);
+
+void runBenchmarks(TFT_eSPI *tft, GfxUi *ui, AsyncBlitter *blitter, ShadowFrame *frame) {
+  log_i("Running benchmarks...");
+  benchmarkCalendar();
+  benchmarkLocalClock();
+  benchmarkAstro();
+  benchmarkCompositing(tft, ui);
+  benchmarkBlitting(tft, ui, blitter);
+  benchmarkShadowFrame(tft, frame);
+  log_i("...benchmarks done.");
+}
+
+/**
+ * Runs SunMoonCalc for every row of the reference table (several locations, 20 years) and reports
+ * the time per calculation and the deviation from the reference sunrise/sunset and moon age.
+ */
+void benchmarkAstro() {
+  const uint16_t rows = sizeof(EPHEMERIS_REFERENCE) / sizeof(EPHEMERIS_REFERENCE[0]);
+  double sunErrorSum = 0, sunErrorMax = 0, moonAgeErrorSum = 0, moonAgeErrorMax = 0;
+  unsigned long totalMicros = 0;
+
+  for (uint16_t i = 0; i < rows; i++) {
+    const EphemerisReference *reference = &EPHEMERIS_REFERENCE[i];
+    unsigned long startMicros = micros();
+    SunMoonCalc smCalc = SunMoonCalc(reference->timestamp, reference->lat, reference->lon);
+    const SunMoonCalc::Result result = smCalc.calculateSunAndMoonData();
+    totalMicros += micros() - startMicros;
+
+    double riseError = fabs((double)result.sun.rise - reference->sunRise);
+    double setError = fabs((double)result.sun.set - reference->sunSet);
+    sunErrorSum += riseError + setError;
+    sunErrorMax = max(sunErrorMax, max(riseError, setError));
+
+    // ages right before and after new moon are only a few hours apart
+    double moonAgeError = fabs(result.moon.age - reference->moonAge);
+    if (moonAgeError > LUNAR_MONTH / 2) moonAgeError = LUNAR_MONTH - moonAgeError;
+    moonAgeErrorSum += moonAgeError;
+    moonAgeErrorMax = max(moonAgeErrorMax, moonAgeError);
+  }
+
+  log_i("SunMoonCalc: %.0f ns/call over %d samples", totalMicros * 1000.0 / rows, rows);
+  log_i("- sunrise/sunset error: mean %.0fs, max %.0fs", sunErrorSum / (2 * rows), sunErrorMax);
+  log_i("- moon age error: mean %.2fh, max %.2fh", moonAgeErrorSum * 24 / rows,
+        moonAgeErrorMax * 24);
+}
+
+/**
+ * Draws RLE icons of all sets plus the JPEG logo synchronously and through the double-buffered
+ * blitter and reports the speedup.
+ */
+void benchmarkBlitting(TFT_eSPI *tft, GfxUi *ui, AsyncBlitter *blitter) {
+  ui->setBlitter(nullptr);
+  unsigned long syncMicros = benchmarkBlitMicros(tft, ui);
+  ui->setBlitter(blitter);
+  unsigned long asyncMicros = benchmarkBlitMicros(tft, ui);
+  log_i("Blitting: %lu us synchronous, %lu us double-buffered, speedup %.2fx", syncMicros,
+        asyncMicros, (float)syncMicros / asyncMicros);
+  tft->fillScreen(TFT_BLACK);
+}
+
+unsigned long benchmarkBlitMicros(TFT_eSPI *tft, GfxUi *ui) {
+  tft->fillScreen(TFT_BLACK);
+  unsigned long startMicros = micros();
+  for (uint16_t i = 0; i < BENCHMARK_BLIT_ITERATIONS; i++) {
+    ui->drawLogo();
+    ui->drawBmp("/moon/m-phase-12.bmp", 10, 10);
+    ui->drawBmp("/weather/rain.bmp", 100, 10);
+    ui->drawBmp("/weather-small/cloudy.bmp", 210, 10);
+    ui->drawBmp("/wind/NE.bmp", 10, 120);
+  }
+  return micros() - startMicros;
+}
+
+/**
+ * Checks mkgmtime() as the inverse of gmtime() from 1970 until the end of the 32bit time_t range
+ * and times mkgmtime() and days_from_epoch().
+ */
+void benchmarkCalendar() {
+  uint32_t samples = 0, mismatches = 0;
+  for (int64_t t = 0; t < INT32_MAX; t += BENCHMARK_TIMESTAMP_STEP, samples++) {
+    time_t timestamp = (time_t)t;
+    struct tm utc;
+    gmtime_r(&timestamp, &utc);
+    if (mkgmtime(&utc) != timestamp) {
+      if (mismatches++ == 0) {
+        log_e("mkgmtime(gmtime(%ld)) = %ld", (long)timestamp, (long)mkgmtime(&utc));
+      }
+    }
+  }
+  log_i("mkgmtime: %u mismatches in %u samples", mismatches, samples);
+
+  // time the conversions on a prepared set of dates so gmtime() doesn't count
+  const uint8_t dates = 64;
+  struct tm utcDates[dates];
+  for (uint8_t i = 0; i < dates; i++) {
+    time_t timestamp = (time_t)((int64_t)i * (INT32_MAX / dates));
+    gmtime_r(&timestamp, &utcDates[i]);
+  }
+
+  unsigned long startMicros = micros();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    benchmarkSink = mkgmtime(&utcDates[i % dates]);
+  }
+  log_i("mkgmtime: %.0f ns/call", (micros() - startMicros) * 1000.0 / BENCHMARK_ITERATIONS);
+
+  startMicros = micros();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    const struct tm *date = &utcDates[i % dates];
+    benchmarkSink = days_from_epoch(date->tm_year + 1900, date->tm_mon + 1, date->tm_mday);
+  }
+  log_i("days_from_epoch: %.0f ns/call", (micros() - startMicros) * 1000.0 / BENCHMARK_ITERATIONS);
+}
+
+bool isSameLocalTime(const struct tm *a, const struct tm *b) {
+  return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday &&
+         a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec &&
+         a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday && a->tm_isdst == b->tm_isdst;
+}
+
+/**
+ * Checks the cached local time against localtime_r() over a decade in several time zones, on both
+ * sides of every DST transition the cache finds in particular, and times both.
+ */
+void benchmarkLocalClock() {
+  const char *zones[] = {config.timezone, "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3",
+                         "NZST-12NZDT,M9.5.0,M4.1.0/3", "<+0530>-5:30", "<-03>3"};
+  for (uint8_t z = 0; z < sizeof(zones) / sizeof(zones[0]); z++) {
+    setTimezone(zones[z]);
+    uint32_t samples = 0, mismatches = 0, transitions = 0;
+    time_t lastTransition = 0;
+    for (time_t t = BENCHMARK_LOCAL_CLOCK_FROM;
+         t < BENCHMARK_LOCAL_CLOCK_FROM + BENCHMARK_LOCAL_CLOCK_SECONDS;
+         t += BENCHMARK_LOCAL_CLOCK_STEP) {
+      time_t checks[] = {t, 0, 0};
+      uint8_t checkCount = 1;
+      struct tm cached, reference;
+      updateLocalClock(t, &cached);
+      LocalClock clock = readLocalClock();
+      // the window of zones without DST ends a year ahead, not at a transition
+      if (clock.nextTransition != lastTransition &&
+          utcOffsetAt(clock.nextTransition, nullptr) != clock.utcOffset) {
+        lastTransition = clock.nextTransition;
+        checks[checkCount++] = lastTransition - 1;
+        checks[checkCount++] = lastTransition;
+        transitions++;
+      }
+      for (uint8_t i = 0; i < checkCount; i++, samples++) {
+        updateLocalClock(checks[i], &cached);
+        localtime_r(&checks[i], &reference);
+        if (!isSameLocalTime(&cached, &reference) && mismatches++ == 0) {
+          char timestamp[TIMESTAMP_LENGTH];
+          strftime(timestamp, sizeof(timestamp), SYSTEM_TIMESTAMP_FORMAT, &cached);
+          log_e("%s: local time of %ld is %s", zones[z], (long)checks[i], timestamp);
+        }
+      }
+    }
+    log_i("Local clock '%s': %u mismatches in %u samples, %u transitions", zones[z], mismatches,
+          samples, transitions);
+  }
+  setTimezone(config.timezone);
+
+  // the clock path, one call per second
+  struct tm local;
+  time_t start = BENCHMARK_LOCAL_CLOCK_FROM;
+  unsigned long startMicros = micros();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    time_t timestamp = start + i;
+    benchmarkSink = localtime_r(&timestamp, &local)->tm_sec;
+  }
+  log_i("localtime_r: %.0f ns/call", (micros() - startMicros) * 1000.0 / BENCHMARK_ITERATIONS);
+  startMicros = micros();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+    benchmarkSink = updateLocalClock(start + i, &local)->tm_sec;
+  }
+  log_i("updateLocalClock: %.0f ns/call", (micros() - startMicros) * 1000.0 / BENCHMARK_ITERATIONS);
+}
+
+/**
+ * Composites the weather icons (alpha channel) onto a non-black sprite and reports the throughput
+ * in pixels per second, next to drawing them to the display opaquely with drawBmp(). Both include
+ * loading the asset, which is a copy from the file system unless the asset archive is mapped.
+ */
+void benchmarkCompositing(TFT_eSPI *tft, GfxUi *ui) {
+  const char *icons[] = {"/weather/clear-day.bmp", "/weather/partly-cloudy-night.bmp",
+                         "/weather/rain.bmp", "/weather/thunderstorm.bmp", "/weather/fog.bmp"};
+  const uint8_t iconCount = sizeof(icons) / sizeof(icons[0]);
+  const uint32_t pixels = (uint32_t)BENCHMARK_COMPOSITE_ITERATIONS * iconCount *
+                          BENCHMARK_ICON_SIZE * BENCHMARK_ICON_SIZE;
+
+  TFT_eSprite sprite = TFT_eSprite(tft);
+  if (sprite.createSprite(BENCHMARK_ICON_SIZE, BENCHMARK_ICON_SIZE) == nullptr) {
+    log_e("Failed to create benchmark sprite.");
+    return;
+  }
+  // a themed, non-black background
+  sprite.fillSprite(0x2945);
+
+  unsigned long startMicros = micros();
+  for (uint16_t i = 0; i < BENCHMARK_COMPOSITE_ITERATIONS; i++) {
+    for (uint8_t icon = 0; icon < iconCount; icon++) {
+      ui->compositeImage(&sprite, icons[icon], 0, 0);
+    }
+  }
+  unsigned long compositeMicros = micros() - startMicros;
+  log_i("compositeImage: %.2f Mpixels/s", (float)pixels / compositeMicros);
+
+  startMicros = micros();
+  for (uint16_t i = 0; i < BENCHMARK_COMPOSITE_ITERATIONS; i++) {
+    for (uint8_t icon = 0; icon < iconCount; icon++) {
+      ui->drawBmp(icons[icon], 0, 0);
+    }
+  }
+  log_i("drawBmp: %.2f Mpixels/s", (float)pixels / (micros() - startMicros));
+  tft->fillScreen(TFT_BLACK);
+  sprite.deleteSprite();
+}
+
+/**
+ * Flushes the shadow frame after redrawing all of it, after changing the seconds of the clock and
+ * with nothing changed, and reports the bytes pushed and the time per flush for each.
+ */
+void benchmarkShadowFrame(TFT_eSPI *tft, ShadowFrame *frame) {
+  TFT_eSprite *canvas = frame->canvas();
+  if (canvas == nullptr) return;
+  const char *scenarios[] = {"full redraw", "clock seconds", "unchanged"};
+  for (uint8_t scenario = 0; scenario < 3; scenario++) {
+    uint32_t bytes = 0;
+    unsigned long flushMicros = 0;
+    for (uint16_t i = 0; i < BENCHMARK_FLUSH_ITERATIONS; i++) {
+      if (scenario == 0) {
+        frame->invalidate();
+        canvas->fillScreen(i & 1 ? 0x2945 : TFT_BLACK);
+      } else if (scenario == 1) {
+        // roughly the two digits of the seconds in the 48px font
+        canvas->fillRect(240, 30, 56, 44, i & 1 ? TFT_WHITE : TFT_BLACK);
+      }
+      unsigned long startMicros = micros();
+      bytes += frame->flush();
+      flushMicros += micros() - startMicros;
+    }
+    log_i("ShadowFrame %s: %u bytes, %lu us per flush", scenarios[scenario],
+          bytes / BENCHMARK_FLUSH_ITERATIONS, flushMicros / BENCHMARK_FLUSH_ITERATIONS);
+  }
+  canvas->fillScreen(TFT_BLACK);
+  frame->invalidate();
+  tft->fillScreen(TFT_BLACK);
+}
+
+/**
+ * Renders full frames of the given widgets into the shadow frame, invalidated so every frame is
+ * pushed entirely, and logs per widget averages as JSON: wall time including the push to the
+ * display, bytes pushed over SPI, glyphs drawn, assets read from the file system and heap
+ * allocations. Widgets draw the fixed dataset from benchmark_dataset.h at a frozen clock.
+ */
+void benchmarkFrames(ShadowFrame *frame, AssetStore *assets, const BenchmarkWidget *widgets,
+                     uint8_t count) {
+  TFT_eSprite *canvas = frame->canvas();
+  WidgetStats *stats = (WidgetStats *)calloc(count, sizeof(WidgetStats));
+  if (canvas == nullptr || stats == nullptr) {
+    log_e("Frame benchmark needs the shadow frame.");
+    free(stats);
+    return;
+  }
+
+  for (uint16_t i = 0; i < BENCHMARK_FRAMES; i++) {
+    freezeBenchmarkClock();
+    canvas->fillScreen(TFT_BLACK);
+    frame->invalidate();
+    for (uint8_t w = 0; w < count; w++) {
+      const RectangleDef *region = widgets[w].region;
+      uint32_t bytes = frame->bytesPushed();
+      uint32_t glyphs = benchmarkGlyphs;
+      uint32_t reads = assets->reads();
+      benchmarkAllocations = 0;
+      benchmarkCountAllocations = true;
+      unsigned long startMicros = micros();
+
+      canvas->fillRect(region->x, region->y, region->width, region->height, TFT_BLACK);
+      widgets[w].draw();
+      frame->flush(region->x, region->y, region->width, region->height);
+
+      stats[w].micros += micros() - startMicros;
+      benchmarkCountAllocations = false;
+      stats[w].allocations += benchmarkAllocations;
+      stats[w].spiBytes += frame->bytesPushed() - bytes;
+      stats[w].glyphs += benchmarkGlyphs - glyphs;
+      stats[w].assetReads += assets->reads() - reads;
+    }
+  }
+  logFrameBenchmark(widgets, stats, count);
+  free(stats);
+  canvas->fillScreen(TFT_BLACK);
+  frame->invalidate();
+}
+
+// Fills the weather data with the fixed dataset. The Strings are the only ones the widgets use.
+void loadBenchmarkDataset(WeatherSnapshot *snapshot) {
+  clearSnapshot(snapshot);
+  CurrentRecord *current = &snapshot->current;
+  current->lat = 47.3769;
+  current->lon = 8.5417;
+  current->condition = conditionIndex(802);
+  strlcpy(current->description, "scattered clouds", sizeof(current->description));
+  current->temp = toHundredths(11.4);
+  current->pressure = 1021;
+  current->humidity = 81;
+  current->windSpeed = toHundredths(2.6);
+  current->windDeg = 240;
+  current->observationTime = BENCHMARK_FRAME_TIMESTAMP;
+  current->sunrise = 1696137926;
+  current->sunset = 1696179771;
+
+  const uint8_t rows = sizeof(BENCHMARK_FORECASTS) / sizeof(BENCHMARK_FORECASTS[0]);
+  for (uint8_t i = 0; i < WEATHER_SNAPSHOT_FORECASTS && i < rows; i++) {
+    ForecastRecord *forecast = &snapshot->forecasts[snapshot->forecastCount++];
+    forecast->observationTime = BENCHMARK_FORECASTS[i].observationTime;
+    forecast->temp = toHundredths(BENCHMARK_FORECASTS[i].temp);
+    forecast->condition = conditionIndex(BENCHMARK_FORECASTS[i].weatherId);
+    forecast->rain = toHundredths(BENCHMARK_FORECASTS[i].rain);
+    forecast->pop = BENCHMARK_FORECASTS[i].pop;
+  }
+}
+
+// UTF-8 continuation bytes don't start a character.
+uint32_t countGlyphs(const char *text) {
+  uint32_t glyphs = 0;
+  for (; *text; text++) {
+    if ((*text & 0xC0) != 0x80) glyphs++;
+  }
+  return glyphs;
+}
+
+void freezeBenchmarkClock() {
+  struct timeval frozen = {BENCHMARK_FRAME_TIMESTAMP, 0};
+  settimeofday(&frozen, nullptr);
+}
+
+void logFrameBenchmark(const BenchmarkWidget *widgets, const WidgetStats *stats, uint8_t count) {
+  uint32_t frameMicros = 0;
+  Serial.printf(BENCHMARK_JSON_PREFIX "{\"frames\":%d,\"widgets\":{", BENCHMARK_FRAMES);
+  for (uint8_t w = 0; w < count; w++) {
+    frameMicros += stats[w].micros / BENCHMARK_FRAMES;
+    Serial.printf("%s\"%s\":{\"micros\":%u,\"spiBytes\":%u,\"glyphs\":%u,\"assetReads\":%u,"
+                  "\"allocations\":%u}", w > 0 ? "," : "", widgets[w].name,
+                  stats[w].micros / BENCHMARK_FRAMES, stats[w].spiBytes / BENCHMARK_FRAMES,
+                  stats[w].glyphs / BENCHMARK_FRAMES, stats[w].assetReads / BENCHMARK_FRAMES,
+                  stats[w].allocations / BENCHMARK_FRAMES);
+  }
+  Serial.printf("},\"frameMicros\":%u}\n", frameMicros);
+  log_i("Frame benchmark: %u us per frame, see " BENCHMARK_JSON_PREFIX "line.", frameMicros);
+}
+
+// Linked in place of the C library's allocation functions with -Wl,--wrap (see the benchmark
+// environment in platformio.ini), which covers new and String as well.
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+  if (benchmarkCountAllocations) benchmarkAllocations++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  if (benchmarkCountAllocations) benchmarkAllocations++;
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  if (benchmarkCountAllocations) benchmarkAllocations++;
+  return __real_realloc(ptr, size);
+}
+}
+
+#else
+
+#define BENCHMARK_COUNT_GLYPHS(text)
+
+#endif
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Fixed weather data for the frame benchmark so its results only change with the rendering code.
+// Zurich on 2023-10-01, the clock is frozen at BENCHMARK_FRAME_TIMESTAMP.
+
+#define BENCHMARK_FRAME_TIMESTAMP 1696147200 // 2023-10-01 08:00:00 UTC
+
+typedef struct BenchmarkForecast {
+  uint32_t observationTime;
+  float temp;
+  uint16_t weatherId;
+  float rain;
+  // percent
+  uint8_t pop;
+} BenchmarkForecast;
+
+const BenchmarkForecast BENCHMARK_FORECASTS[] = {
+  {1696150800, 13.0, 800, 0.0, 0},
+  {1696161600, 17.2, 800, 0.0, 0},
+  {1696172400, 18.8, 800, 0.0, 0},
+  {1696183200, 17.0, 800, 0.0, 0},
+  {1696194000, 12.7, 801, 0.0, 0},
+  {1696204800, 8.4, 801, 0.0, 0},
+  {1696215600, 6.5, 801, 0.0, 0},
+  {1696226400, 8.2, 801, 0.0, 0},
+  {1696237200, 12.4, 802, 0.0, 0},
+  {1696248000, 16.5, 802, 0.0, 0},
+  {1696258800, 18.2, 802, 0.0, 0},
+  {1696269600, 16.4, 802, 0.0, 0},
+  {1696280400, 12.0, 803, 0.0, 10},
+  {1696291200, 7.7, 803, 0.0, 10},
+  {1696302000, 5.9, 803, 0.0, 10},
+  {1696312800, 7.6, 803, 0.0, 10},
+  {1696323600, 11.7, 804, 0.0, 20},
+  {1696334400, 15.9, 804, 0.0, 20},
+  {1696345200, 17.6, 804, 0.0, 20},
+  {1696356000, 15.7, 804, 0.0, 20},
+  {1696366800, 11.4, 500, 1.0, 90},
+  {1696377600, 7.1, 500, 0.4, 60},
+  {1696388400, 5.2, 500, 0.7, 75},
+  {1696399200, 6.9, 500, 1.0, 90},
+  {1696410000, 11.1, 501, 0.4, 60},
+  {1696420800, 15.2, 501, 0.7, 75},
+  {1696431600, 16.9, 501, 1.0, 90},
+  {1696442400, 15.1, 501, 0.4, 60},
+  {1696453200, 10.8, 500, 0.7, 75},
+  {1696464000, 6.4, 500, 1.0, 90},
+  {1696474800, 4.6, 500, 0.4, 60},
+  {1696485600, 6.3, 500, 0.7, 75},
+  {1696496400, 10.4, 803, 0.0, 10},
+  {1696507200, 14.6, 803, 0.0, 10},
+  {1696518000, 16.3, 803, 0.0, 10},
+  {1696528800, 14.4, 803, 0.0, 10},
+  {1696539600, 10.1, 802, 0.0, 0},
+  {1696550400, 5.8, 802, 0.0, 0},
+  {1696561200, 4.0, 802, 0.0, 0},
+  {1696572000, 5.6, 802, 0.0, 0},
+};
@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+
+#include "settings.h"
+
+// the configuration is kept as one blob in this NVS namespace
+#define CONFIG_NAMESPACE "config"
+#define CONFIG_KEY "settings"
+// bump whenever the layout of Config changes, stored configurations of other versions are replaced
+// by the defaults from settings.h
+#define CONFIG_VERSION 1
+#define CONFIG_MAX_LISTENERS 8
+// longest line the serial console accepts
+#define CONFIG_COMMAND_LENGTH 128
+
+// groups of settings, listeners are only notified of the groups they registered for
+#define CONFIG_WIFI (1 << 0)
+#define CONFIG_API_KEY (1 << 1)
+#define CONFIG_LOCATIONS (1 << 2)
+#define CONFIG_UNITS (1 << 3)
+#define CONFIG_TIMEZONE (1 << 4)
+#define CONFIG_UPDATE_INTERVAL (1 << 5)
+
+typedef struct ConfigLocation {
+  char id[12];
+  char name[24];
+} ConfigLocation;
+
+/**
+ * The user settings that can be changed at runtime, persisted in NVS. The compile-time values in
+ * settings.h are the defaults. On the loop task, reading the fields of config is as cheap as
+ * reading the constants was, changes go through commitConfig(). Other tasks take a copy with
+ * readConfig() since a change may be committed meanwhile.
+ */
+typedef struct Config {
+  uint16_t version;
+  char ssid[33];
+  char wifiPassword[65];
+  char apiKey[33];
+  ConfigLocation locations[LOCATION_COUNT];
+  bool isMetric;
+  // POSIX TZ string
+  char timezone[64];
+  uint16_t updateIntervalMinutes;
+} Config;
+
+/**
+ * Called on the loop task after a change was stored.
+ *
+ * @param changed CONFIG_xyz groups that changed, only those the listener registered for
+ * @param previous the configuration before the change
+ */
+typedef void (*ConfigListener)(uint32_t changed, const Config *previous);
+
+typedef struct ConfigSubscription {
+  uint32_t groups;
+  ConfigListener listener;
+} ConfigSubscription;
+
+Config config;
+// held while config is replaced or copied for another task
+portMUX_TYPE configMux = portMUX_INITIALIZER_UNLOCKED;
+ConfigSubscription configListeners[CONFIG_MAX_LISTENERS];
+uint8_t configListenerCount = 0;
+char configCommand[CONFIG_COMMAND_LENGTH];
+uint8_t configCommandLength = 0;
+
+void loadDefaultConfig(Config *defaults);
+void logConfig();
+void saveConfig();
+
+// Loads the stored configuration, or the defaults if there's none of CONFIG_VERSION.
+void initConfig() {
+  Preferences preferences;
+  size_t size = 0;
+  if (preferences.begin(CONFIG_NAMESPACE, true)) {
+    size = preferences.getBytes(CONFIG_KEY, &config, sizeof(Config));
+    preferences.end();
+  }
+  // a different number of locations changes the size, too
+  if (size != sizeof(Config) || config.version != CONFIG_VERSION) {
+    log_i("No stored configuration, using the defaults from settings.h.");
+    loadDefaultConfig(&config);
+  }
+  logConfig();
+}
+
+void loadDefaultConfig(Config *defaults) {
+  memset(defaults, 0, sizeof(Config));
+  defaults->version = CONFIG_VERSION;
+  strlcpy(defaults->ssid, SSID, sizeof(defaults->ssid));
+  strlcpy(defaults->wifiPassword, WIFI_PWD, sizeof(defaults->wifiPassword));
+  strlcpy(defaults->apiKey, OPEN_WEATHER_MAP_API_KEY.c_str(), sizeof(defaults->apiKey));
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    ConfigLocation *location = &defaults->locations[i];
+    strlcpy(location->id, OPEN_WEATHER_MAP_LOCATIONS[i][0], sizeof(location->id));
+    strlcpy(location->name, OPEN_WEATHER_MAP_LOCATIONS[i][1], sizeof(location->name));
+  }
+  defaults->isMetric = IS_METRIC;
+  strlcpy(defaults->timezone, TIMEZONE, sizeof(defaults->timezone));
+  defaults->updateIntervalMinutes = UPDATE_INTERVAL_MINUTES;
+}
+
+void logConfig() {
+  log_i("WiFi '%s', %d locations, %s units, timezone '%s', update interval %d min.", config.ssid,
+        LOCATION_COUNT, config.isMetric ? "metric" : "imperial", config.timezone,
+        config.updateIntervalMinutes);
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    log_i("location%d: %s %s", i, config.locations[i].id, config.locations[i].name);
+  }
+}
+
+void saveConfig() {
+  Preferences preferences;
+  if (!preferences.begin(CONFIG_NAMESPACE, false) ||
+      preferences.putBytes(CONFIG_KEY, &config, sizeof(Config)) != sizeof(Config)) {
+    log_e("Failed to store the configuration.");
+  }
+  preferences.end();
+}
+
+// A consistent copy of the configuration for tasks other than the loop.
+void readConfig(Config *copy) {
+  portENTER_CRITICAL(&configMux);
+  *copy = config;
+  portEXIT_CRITICAL(&configMux);
+}
+
+// Registers a listener for changes to any of the CONFIG_xyz groups.
+void onConfigChange(uint32_t groups, ConfigListener listener) {
+  if (configListenerCount == CONFIG_MAX_LISTENERS) {
+    log_e("Too many configuration listeners.");
+    return;
+  }
+  configListeners[configListenerCount++] = {groups, listener};
+}
+
+// The CONFIG_xyz groups that differ between the two.
+uint32_t diffConfig(const Config *a, const Config *b) {
+  uint32_t changed = 0;
+  if (strcmp(a->ssid, b->ssid) != 0 || strcmp(a->wifiPassword, b->wifiPassword) != 0) {
+    changed |= CONFIG_WIFI;
+  }
+  if (strcmp(a->apiKey, b->apiKey) != 0) changed |= CONFIG_API_KEY;
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    if (strcmp(a->locations[i].id, b->locations[i].id) != 0 ||
+        strcmp(a->locations[i].name, b->locations[i].name) != 0) {
+      changed |= CONFIG_LOCATIONS;
+    }
+  }
+  if (a->isMetric != b->isMetric) changed |= CONFIG_UNITS;
+  if (strcmp(a->timezone, b->timezone) != 0) changed |= CONFIG_TIMEZONE;
+  if (a->updateIntervalMinutes != b->updateIntervalMinutes) changed |= CONFIG_UPDATE_INTERVAL;
+  return changed;
+}
+
+/**
+ * Replaces the configuration, stores it and notifies the listeners of the groups that changed.
+ * Only the loop task may call this.
+ *
+ * @return CONFIG_xyz groups that changed
+ */
+uint32_t commitConfig(const Config *next) {
+  uint32_t changed = diffConfig(&config, next);
+  if (changed == 0) return 0;
+  Config previous = config;
+  portENTER_CRITICAL(&configMux);
+  config = *next;
+  portEXIT_CRITICAL(&configMux);
+  saveConfig();
+  for (uint8_t i = 0; i < configListenerCount; i++) {
+    if (configListeners[i].groups & changed) {
+      configListeners[i].listener(configListeners[i].groups & changed, &previous);
+    }
+  }
+  return changed;
+}
+
+/**
+ * Sets one value by its name as printed by logConfig(): ssid, password, apikey, locationN ("id
+ * name"), units (metric/imperial), timezone or interval (minutes).
+ *
+ * @return false if the name or value isn't valid, target is unchanged then
+ */
+bool setConfigValue(Config *target, const char *name, const char *value) {
+  if (strcmp(name, "ssid") == 0) {
+    strlcpy(target->ssid, value, sizeof(target->ssid));
+  } else if (strcmp(name, "password") == 0) {
+    strlcpy(target->wifiPassword, value, sizeof(target->wifiPassword));
+  } else if (strcmp(name, "apikey") == 0) {
+    strlcpy(target->apiKey, value, sizeof(target->apiKey));
+  } else if (strncmp(name, "location", 8) == 0) {
+    // digits only, a typo must not end up as location 0
+    const char *digits = name + 8;
+    char *end;
+    long index = strtol(digits, &end, 10);
+    if (!isdigit((unsigned char)digits[0]) || *end != 0) return false;
+    const char *separator = strchr(value, ' ');
+    if (index >= (long)LOCATION_COUNT || separator == nullptr) return false;
+    ConfigLocation *location = &target->locations[index];
+    strlcpy(location->id, value, min(sizeof(location->id), (size_t)(separator - value + 1)));
+    strlcpy(location->name, separator + 1, sizeof(location->name));
+  } else if (strcmp(name, "units") == 0) {
+    if (strcmp(value, "metric") != 0 && strcmp(value, "imperial") != 0) return false;
+    target->isMetric = strcmp(value, "metric") == 0;
+  } else if (strcmp(name, "timezone") == 0) {
+    strlcpy(target->timezone, value, sizeof(target->timezone));
+  } else if (strcmp(name, "interval") == 0) {
+    int minutes = atoi(value);
+    if (minutes <= 0 || minutes > UINT16_MAX) return false;
+    target->updateIntervalMinutes = minutes;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Runs a line of the serial console: "config" logs the configuration, "set <name> <value>" changes
+ * a value (see setConfigValue()) and "reset" goes back to the defaults.
+ */
+void runConfigCommand(char *line) {
+  if (strcmp(line, "config") == 0) {
+    logConfig();
+    return;
+  }
+  Config next = config;
+  if (strcmp(line, "reset") == 0) {
+    loadDefaultConfig(&next);
+  } else if (strncmp(line, "set ", 4) == 0) {
+    char *name = line + 4;
+    char *value = strchr(name, ' ');
+    if (value == nullptr) {
+      log_e("Usage: set <name> <value>");
+      return;
+    }
+    *value++ = 0;
+    if (!setConfigValue(&next, name, value)) {
+      log_e("Invalid setting '%s' or value '%s'.", name, value);
+      return;
+    }
+  } else {
+    log_e("Unknown command '%s', try config, set <name> <value> or reset.", line);
+    return;
+  }
+  uint32_t changed = commitConfig(&next);
+  log_i("Configuration stored, changed groups: 0x%02x.", changed);
+}
+
+// Reads what arrived on the serial console without blocking, call from the loop.
+void handleConfigCommands() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c == '\r') continue;
+    if (c != '\n') {
+      if (configCommandLength < CONFIG_COMMAND_LENGTH - 1) configCommand[configCommandLength++] = c;
+      continue;
+    }
+    configCommand[configCommandLength] = 0;
+    configCommandLength = 0;
+    if (configCommand[0] != 0) runConfigCommand(configCommand);
+  }
+}
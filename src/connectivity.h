@@ -5,14 +5,29 @@
 
 #include <WiFi.h>
 
-#include "settings.h"
+#include "config.h"
 
+// Runs on the boot task or the loop.
 void startWiFi() {
-  WiFi.begin(SSID, WIFI_PWD);
-  log_i("Connecting to WiFi '%s'...", SSID);
+  Config current;
+  readConfig(&current);
+  WiFi.begin(current.ssid, current.wifiPassword);
+  log_i("Connecting to WiFi '%s'...", current.ssid);
   while (WiFi.status() != WL_CONNECTED) {
     log_i(".");
     delay(200);
   }
   log_i("...done. IP: %s, WiFi RSSI: %d.", WiFi.localIP().toString().c_str(), WiFi.RSSI());
 }
+
+// The connection isn't maintained through light sleep anyway, see power.h.
+void stopWiFi() {
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+  log_i("WiFi off.");
+}
+
+// Other credentials are used from the next connection on, so the current one is dropped.
+void onWiFiConfigChange(uint32_t changed, const Config *previous) {
+  if (WiFi.status() == WL_CONNECTED) stopWiFi();
+}
@@ -5,14 +5,24 @@
 
 #include <FT6236.h>
 #include <TFT_eSPI.h>
+#include <driver/ledc.h>
 
 #include "settings.h"
 
+// The low-speed group can be clocked from RTC8M, which keeps the PWM running in light sleep
+// (see power.h). Channels/timers of the other group stop with the APB clock.
+#define BACKLIGHT_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_LEDC_CHANNEL LEDC_CHANNEL_0
+#define BACKLIGHT_LEDC_TIMER LEDC_TIMER_0
+#define BACKLIGHT_PWM_FREQUENCY 5000
+
 // The library defines the type "setup_t" as a struct
 // Calling tft.getSetup(user) populates it with the settings
 setup_t user;
 
+void initBacklight();
 uint8_t readRegister8(uint8_t reg);
+void setBacklight(uint8_t brightness);
 
 void initTft(TFT_eSPI *tft) {
   tft->init();
@@ -26,14 +36,44 @@ void initTft(TFT_eSPI *tft) {
   log_i("No TFT backlight pin defined.");
 #else
   log_d("Configuring TFT backlight at pin %d.", TFT_BL);
-  // Setup PWM channel, ledc is a LED Control Function
-  ledcSetup(0, 5000, 8);
-  ledcAttachPin(TFT_BL, 0);
-  ledcWrite(0, TFT_LED_BRIGHTNESS);
+  initBacklight();
+  setBacklight(TFT_LED_BRIGHTNESS);
 #endif
   tft->fillScreen(TFT_BLACK);
 }
 
+// Sets up the PWM channel of the backlight through the IDF LEDC driver, the Arduino ledc*()
+// functions don't allow to choose the clock source.
+void initBacklight() {
+#ifdef TFT_BL
+  ledc_timer_config_t timerConfig = {};
+  timerConfig.speed_mode = BACKLIGHT_LEDC_MODE;
+  timerConfig.duty_resolution = LEDC_TIMER_8_BIT;
+  timerConfig.timer_num = BACKLIGHT_LEDC_TIMER;
+  timerConfig.freq_hz = BACKLIGHT_PWM_FREQUENCY;
+  timerConfig.clk_cfg = LEDC_USE_RTC8M_CLK;
+
+  ledc_channel_config_t channelConfig = {};
+  channelConfig.gpio_num = TFT_BL;
+  channelConfig.speed_mode = BACKLIGHT_LEDC_MODE;
+  channelConfig.channel = BACKLIGHT_LEDC_CHANNEL;
+  channelConfig.intr_type = LEDC_INTR_DISABLE;
+  channelConfig.timer_sel = BACKLIGHT_LEDC_TIMER;
+  channelConfig.duty = 0;
+
+  if (ledc_timer_config(&timerConfig) != ESP_OK || ledc_channel_config(&channelConfig) != ESP_OK) {
+    log_e("Failed to configure the backlight PWM.");
+  }
+#endif
+}
+
+void setBacklight(uint8_t brightness) {
+#ifdef TFT_BL
+  ledc_set_duty(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL, brightness);
+  ledc_update_duty(BACKLIGHT_LEDC_MODE, BACKLIGHT_LEDC_CHANNEL);
+#endif
+}
+
 void initTouchScreen(FT6236 *ts) {
   if (ts->begin(TOUCH_SENSITIVITY, TOUCH_SDA, TOUCH_SCL)) {
     log_i("Capacitive touch started.");
@@ -0,0 +1,520 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+// Generated by scripts/generate_ephemeris.py - do not edit.
+
+#pragma once
+
+typedef struct EphemerisReference {
+  // local solar noon (UTC), the timestamp to calculate for
+  int32_t timestamp;
+  float lat;
+  float lon;
+  int32_t sunRise;
+  int32_t sunSet;
+  // days since new moon
+  float moonAge;
+} EphemerisReference;
+
+const EphemerisReference EPHEMERIS_REFERENCE[] = {
+  {1514805949, 47.3769, 8.5417, 1514790789, 1514821547, 14.2050}, // Zurich
+  {1521113149, 47.3769, 8.5417, 1521092354, 1521135066, 27.5973}, // Zurich
+  {1527420349, 47.3769, 8.5417, 1527392218, 1527448177, 11.9843}, // Zurich
+  {1533727549, 47.3769, 8.5417, 1533701562, 1533754165, 26.3593}, // Zurich
+  {1540034749, 47.3769, 8.5417, 1540014674, 1540052956, 11.3183}, // Zurich
+  {1546341949, 47.3769, 8.5417, 1546326789, 1546357533, 25.1701}, // Zurich
+  {1552649149, 47.3769, 8.5417, 1552628384, 1552671045, 8.8069}, // Zurich
+  {1558956349, 47.3769, 8.5417, 1558928231, 1558984162, 22.5281}, // Zurich
+  {1565263549, 47.3769, 8.5417, 1565237544, 1565290188, 7.3428}, // Zurich
+  {1571570749, 47.3769, 8.5417, 1571550653, 1571588982, 21.7074}, // Zurich
+  {1577877949, 47.3769, 8.5417, 1577862789, 1577893518, 6.2583}, // Zurich
+  {1584185149, 47.3769, 8.5417, 1584164413, 1584207024, 19.8290}, // Zurich
+  {1590492349, 47.3769, 8.5417, 1590464243, 1590520147, 3.7409}, // Zurich
+  {1596799549, 47.3769, 8.5417, 1596773525, 1596826211, 17.7448}, // Zurich
+  {1603106749, 47.3769, 8.5417, 1603086632, 1603125008, 2.6627}, // Zurich
+  {1609500349, 47.3769, 8.5417, 1609485189, 1609515961, 17.7977}, // Zurich
+  {1615807549, 47.3769, 8.5417, 1615786722, 1615829489, 2.0448}, // Zurich
+  {1622114749, 47.3769, 8.5417, 1622086605, 1622142595, 15.6844}, // Zurich
+  {1628421949, 47.3769, 8.5417, 1628395984, 1628448540, 29.4227}, // Zurich
+  {1634729149, 47.3769, 8.5417, 1634709098, 1634747326, 14.0138}, // Zurich
+  {1641036349, 47.3769, 8.5417, 1641021190, 1641051947, 28.1541}, // Zurich
+  {1647343549, 47.3769, 8.5417, 1647322751, 1647365468, 12.7433}, // Zurich
+  {1653650749, 47.3769, 8.5417, 1653622616, 1653678580, 26.6234}, // Zurich
+  {1659957949, 47.3769, 8.5417, 1659931965, 1659984563, 10.7299}, // Zurich
+  {1666265149, 47.3769, 8.5417, 1666245077, 1666283352, 24.5633}, // Zurich
+  {1672572349, 47.3769, 8.5417, 1672557189, 1672587933, 9.0472}, // Zurich
+  {1678879549, 47.3769, 8.5417, 1678858780, 1678901447, 23.1798}, // Zurich
+  {1685186749, 47.3769, 8.5417, 1685158628, 1685214565, 7.8142}, // Zurich
+  {1691493949, 47.3769, 8.5417, 1691467946, 1691520586, 21.7042}, // Zurich
+  {1697801149, 47.3769, 8.5417, 1697781056, 1697819378, 5.7293}, // Zurich
+  {1704108349, 47.3769, 8.5417, 1704093189, 1704123919, 19.4954}, // Zurich
+  {1710415549, 47.3769, 8.5417, 1710394808, 1710437426, 4.1006}, // Zurich
+  {1716722749, 47.3769, 8.5417, 1716694640, 1716750550, 18.3357}, // Zurich
+  {1723029949, 47.3769, 8.5417, 1723003928, 1723056608, 3.0085}, // Zurich
+  {1729337149, 47.3769, 8.5417, 1729317035, 1729355404, 16.6915}, // Zurich
+  {1735730749, 47.3769, 8.5417, 1735715589, 1735746362, 1.5406}, // Zurich
+  {1742037949, 47.3769, 8.5417, 1742017117, 1742059892, 15.4446}, // Zurich
+  {1748345149, 47.3769, 8.5417, 1748317003, 1748372998, 0.3490}, // Zurich
+  {1754652349, 47.3769, 8.5417, 1754626387, 1754678937, 14.6766}, // Zurich
+  {1760959549, 47.3769, 8.5417, 1760939501, 1760977722, 28.6471}, // Zurich
+  {1767266749, 47.3769, 8.5417, 1767251589, 1767282348, 12.4042}, // Zurich
+  {1773573949, 47.3769, 8.5417, 1773553146, 1773595871, 25.9748}, // Zurich
+  {1779881149, 47.3769, 8.5417, 1779853015, 1779908983, 10.6415}, // Zurich
+  {1786188349, 47.3769, 8.5417, 1786162369, 1786214959, 25.0706}, // Zurich
+  {1792495549, 47.3769, 8.5417, 1792475480, 1792513748, 9.8164}, // Zurich
+  {1798802749, 47.3769, 8.5417, 1798787589, 1798818334, 23.4400}, // Zurich
+  {1805109949, 47.3769, 8.5417, 1805089175, 1805131850, 7.0805}, // Zurich
+  {1811417149, 47.3769, 8.5417, 1811389027, 1811444968, 21.0186}, // Zurich
+  {1817724349, 47.3769, 8.5417, 1817698350, 1817750982, 6.0557}, // Zurich
+  {1824031549, 47.3769, 8.5417, 1824011459, 1824049774, 20.3675}, // Zurich
+  {1830338749, 47.3769, 8.5417, 1830323588, 1830354321, 4.6340}, // Zurich
+  {1836645949, 47.3769, 8.5417, 1836625204, 1836667829, 18.0333}, // Zurich
+  {1842953149, 47.3769, 8.5417, 1842925040, 1842980953, 2.1311}, // Zurich
+  {1849260349, 47.3769, 8.5417, 1849234332, 1849287005, 16.3495}, // Zurich
+  {1855567549, 47.3769, 8.5417, 1855547438, 1855585800, 1.3533}, // Zurich
+  {1861961149, 47.3769, 8.5417, 1861945988, 1861976764, 16.3886}, // Zurich
+  {1868268349, 47.3769, 8.5417, 1868247513, 1868290295, 0.2958}, // Zurich
+  {1874575549, 47.3769, 8.5417, 1874547402, 1874603400, 13.9046}, // Zurich
+  {1880882749, 47.3769, 8.5417, 1880856791, 1880909333, 27.8150}, // Zurich
+  {1887189949, 47.3769, 8.5417, 1887169904, 1887208119, 12.6741}, // Zurich
+  {1893497149, 47.3769, 8.5417, 1893481987, 1893512750, 26.8566}, // Zurich
+  {1899804349, 47.3769, 8.5417, 1899783542, 1899826274, 11.2019}, // Zurich
+  {1906111549, 47.3769, 8.5417, 1906083414, 1906139385, 24.8842}, // Zurich
+  {1912418749, 47.3769, 8.5417, 1912392773, 1912445356, 9.0100}, // Zurich
+  {1918725949, 47.3769, 8.5417, 1918705883, 1918744145, 23.0628}, // Zurich
+  {1925033149, 47.3769, 8.5417, 1925017987, 1925048737, 7.7452}, // Zurich
+  {1931340349, 47.3769, 8.5417, 1931319571, 1931362253, 21.8171}, // Zurich
+  {1937647549, 47.3769, 8.5417, 1937619427, 1937675370, 6.1724}, // Zurich
+  {1943954749, 47.3769, 8.5417, 1943928754, 1943981378, 19.9064}, // Zurich
+  {1950261949, 47.3769, 8.5417, 1950241861, 1950280171, 4.1278}, // Zurich
+  {1956569149, 47.3769, 8.5417, 1956553986, 1956584723, 18.0969}, // Zurich
+  {1962876349, 47.3769, 8.5417, 1962855600, 1962898232, 2.7926}, // Zurich
+  {1969183549, 47.3769, 8.5417, 1969155440, 1969211354, 16.9097}, // Zurich
+  {1975490749, 47.3769, 8.5417, 1975464735, 1975517401, 1.2593}, // Zurich
+  {1981797949, 47.3769, 8.5417, 1981777840, 1981816198, 14.9155}, // Zurich
+  {1988191549, 47.3769, 8.5417, 1988176386, 1988207166, 0.0472}, // Zurich
+  {1994498749, 47.3769, 8.5417, 1994477909, 1994520697, 14.1264}, // Zurich
+  {2000805949, 47.3769, 8.5417, 2000777802, 2000833802, 28.3607}, // Zurich
+  {2007113149, 47.3769, 8.5417, 2007087194, 2007139730, 13.1340}, // Zurich
+  {2013420349, 47.3769, 8.5417, 2013400306, 2013438516, 26.9068}, // Zurich
+  {2019727549, 47.3769, 8.5417, 2019712386, 2019743152, 10.6934}, // Zurich
+  {2026034749, 47.3769, 8.5417, 2026013939, 2026056676, 24.5102}, // Zurich
+  {2032341949, 47.3769, 8.5417, 2032313814, 2032369786, 9.3423}, // Zurich
+  {2038649149, 47.3769, 8.5417, 2038623176, 2038675753, 23.7156}, // Zurich
+  {2044956349, 47.3769, 8.5417, 2044936285, 2044974542, 8.1617}, // Zurich
+  {2051263549, 47.3769, 8.5417, 2051248386, 2051279138, 21.6324}, // Zurich
+  {2057570749, 47.3769, 8.5417, 2057549968, 2057592655, 5.5111}, // Zurich
+  {2063877949, 47.3769, 8.5417, 2063849827, 2063905771, 19.6403}, // Zurich
+  {2070185149, 47.3769, 8.5417, 2070159157, 2070211776, 4.7597}, // Zurich
+  {2076492349, 47.3769, 8.5417, 2076472263, 2076510569, 18.9294}, // Zurich
+  {2082799549, 47.3769, 8.5417, 2082784385, 2082815124, 2.8708}, // Zurich
+  {2089106749, 47.3769, 8.5417, 2089085997, 2089128633, 16.2679}, // Zurich
+  {2095413949, 47.3769, 8.5417, 2095385839, 2095441756, 0.6725}, // Zurich
+  {2101721149, 47.3769, 8.5417, 2101695138, 2101747799, 15.0476}, // Zurich
+  {2108028349, 47.3769, 8.5417, 2108008242, 2108046595, 29.3986}, // Zurich
+  {2114421949, 47.3769, 8.5417, 2114406786, 2114437567, 14.8271}, // Zurich
+  {2120729149, 47.3769, 8.5417, 2120708306, 2120751099, 28.2717}, // Zurich
+  {2127036349, 47.3769, 8.5417, 2127008201, 2127064204, 12.2295}, // Zurich
+  {2133343549, 47.3769, 8.5417, 2133317597, 2133370128, 26.3704}, // Zurich
+  {2139650749, 47.3769, 8.5417, 2139630708, 2139668913, 11.3688}, // Zurich
+  {1514824392, -54.8019, -68.3030, 1514793648, 1514855543, 14.4185}, // Ushuaia
+  {1521131592, -54.8019, -68.3030, 1521109475, 1521154702, 27.8108}, // Ushuaia
+  {1527438792, -54.8019, -68.3030, 1527424651, 1527452573, 12.1978}, // Ushuaia
+  {1533745992, -54.8019, -68.3030, 1533730122, 1533762581, 26.5727}, // Ushuaia
+  {1540053192, -54.8019, -68.3030, 1540026703, 1540077930, 11.5317}, // Ushuaia
+  {1546360392, -54.8019, -68.3030, 1546329630, 1546391547, 25.3836}, // Ushuaia
+  {1552667592, -54.8019, -68.3030, 1552645446, 1552690739, 9.0203}, // Ushuaia
+  {1558974792, -54.8019, -68.3030, 1558960631, 1558988589, 22.7416}, // Ushuaia
+  {1565281992, -54.8019, -68.3030, 1565266152, 1565298556, 7.5563}, // Ushuaia
+  {1571589192, -54.8019, -68.3030, 1571562737, 1571613900, 21.9208}, // Ushuaia
+  {1577896392, -54.8019, -68.3030, 1577865613, 1577927552, 6.4718}, // Ushuaia
+  {1584203592, -54.8019, -68.3030, 1584181417, 1584226776, 20.0425}, // Ushuaia
+  {1590510792, -54.8019, -68.3030, 1590496611, 1590524606, 3.9543}, // Ushuaia
+  {1596817992, -54.8019, -68.3030, 1596802181, 1596834530, 17.9582}, // Ushuaia
+  {1603125192, -54.8019, -68.3030, 1603098772, 1603149871, 2.8761}, // Ushuaia
+  {1609518792, -54.8019, -68.3030, 1609488066, 1609549939, 18.0111}, // Ushuaia
+  {1615825992, -54.8019, -68.3030, 1615803907, 1615849061, 2.2582}, // Ushuaia
+  {1622133192, -54.8019, -68.3030, 1622119074, 1622146954, 15.8979}, // Ushuaia
+  {1628440392, -54.8019, -68.3030, 1628424490, 1628457010, 0.1128}, // Ushuaia
+  {1634747592, -54.8019, -68.3030, 1634721064, 1634772363, 14.2273}, // Ushuaia
+  {1641054792, -54.8019, -68.3030, 1641024048, 1641085943, 28.3676}, // Ushuaia
+  {1647361992, -54.8019, -68.3030, 1647339878, 1647385097, 12.9568}, // Ushuaia
+  {1653669192, -54.8019, -68.3030, 1653655055, 1653682970, 26.8369}, // Ushuaia
+  {1659976392, -54.8019, -68.3030, 1659960520, 1659992985, 10.9434}, // Ushuaia
+  {1666283592, -54.8019, -68.3030, 1666257098, 1666308334, 24.7768}, // Ushuaia
+  {1672590792, -54.8019, -68.3030, 1672560031, 1672621948, 9.2607}, // Ushuaia
+  {1678897992, -54.8019, -68.3030, 1678875849, 1678921134, 23.3933}, // Ushuaia
+  {1685205192, -54.8019, -68.3030, 1685191035, 1685218986, 8.0276}, // Ushuaia
+  {1691512392, -54.8019, -68.3030, 1691496549, 1691528960, 21.9176}, // Ushuaia
+  {1697819592, -54.8019, -68.3030, 1697793132, 1697844305, 5.9428}, // Ushuaia
+  {1704126792, -54.8019, -68.3030, 1704096013, 1704157952, 19.7088}, // Ushuaia
+  {1710433992, -54.8019, -68.3030, 1710411821, 1710457171, 4.3140}, // Ushuaia
+  {1716741192, -54.8019, -68.3030, 1716727015, 1716755002, 18.5491}, // Ushuaia
+  {1723048392, -54.8019, -68.3030, 1723032578, 1723064935, 3.2220}, // Ushuaia
+  {1729355592, -54.8019, -68.3030, 1729329166, 1729380275, 16.9050}, // Ushuaia
+  {1735749192, -54.8019, -68.3030, 1735718467, 1735780338, 1.7540}, // Ushuaia
+  {1742056392, -54.8019, -68.3030, 1742034311, 1742079455, 15.6581}, // Ushuaia
+  {1748363592, -54.8019, -68.3030, 1748349478, 1748377351, 0.5625}, // Ushuaia
+  {1754670792, -54.8019, -68.3030, 1754654886, 1754687415, 14.8901}, // Ushuaia
+  {1760977992, -54.8019, -68.3030, 1760951458, 1761002768, 28.8605}, // Ushuaia
+  {1767285192, -54.8019, -68.3030, 1767254450, 1767316342, 12.6176}, // Ushuaia
+  {1773592392, -54.8019, -68.3030, 1773570282, 1773615492, 26.1883}, // Ushuaia
+  {1779899592, -54.8019, -68.3030, 1779885458, 1779913367, 10.8549}, // Ushuaia
+  {1786206792, -54.8019, -68.3030, 1786190915, 1786223390, 25.2841}, // Ushuaia
+  {1792513992, -54.8019, -68.3030, 1792487492, 1792538738, 10.0299}, // Ushuaia
+  {1798821192, -54.8019, -68.3030, 1798790433, 1798852346, 23.6535}, // Ushuaia
+  {1805128392, -54.8019, -68.3030, 1805106254, 1805151528, 7.2939}, // Ushuaia
+  {1811435592, -54.8019, -68.3030, 1811421438, 1811449384, 21.2321}, // Ushuaia
+  {1817742792, -54.8019, -68.3030, 1817726944, 1817759365, 6.2691}, // Ushuaia
+  {1824049992, -54.8019, -68.3030, 1824023527, 1824074709, 20.5810}, // Ushuaia
+  {1830357192, -54.8019, -68.3030, 1830326416, 1830388350, 4.8475}, // Ushuaia
+  {1836664392, -54.8019, -68.3030, 1836642225, 1836687565, 18.2467}, // Ushuaia
+  {1842971592, -54.8019, -68.3030, 1842957418, 1842985401, 2.3446}, // Ushuaia
+  {1849278792, -54.8019, -68.3030, 1849262973, 1849295340, 16.5629}, // Ushuaia
+  {1855585992, -54.8019, -68.3030, 1855559561, 1855610679, 1.5668}, // Ushuaia
+  {1861979592, -54.8019, -68.3030, 1861948870, 1862010736, 16.6021}, // Ushuaia
+  {1868286792, -54.8019, -68.3030, 1868264715, 1868309850, 0.5093}, // Ushuaia
+  {1874593992, -54.8019, -68.3030, 1874579881, 1874607750, 14.1181}, // Ushuaia
+  {1880901192, -54.8019, -68.3030, 1880885281, 1880917820, 28.0285}, // Ushuaia
+  {1887208392, -54.8019, -68.3030, 1887181854, 1887233171, 12.8875}, // Ushuaia
+  {1893515592, -54.8019, -68.3030, 1893484853, 1893546740, 27.0700}, // Ushuaia
+  {1899822792, -54.8019, -68.3030, 1899800686, 1899845886, 11.4153}, // Ushuaia
+  {1906129992, -54.8019, -68.3030, 1906115860, 1906143767, 25.0977}, // Ushuaia
+  {1912437192, -54.8019, -68.3030, 1912421311, 1912453795, 9.2235}, // Ushuaia
+  {1918744392, -54.8019, -68.3030, 1918717888, 1918769142, 23.2763}, // Ushuaia
+  {1925051592, -54.8019, -68.3030, 1925020836, 1925082743, 7.9587}, // Ushuaia
+  {1931358792, -54.8019, -68.3030, 1931336657, 1931381923, 22.0306}, // Ushuaia
+  {1937665992, -54.8019, -68.3030, 1937651840, 1937679784, 6.3859}, // Ushuaia
+  {1943973192, -54.8019, -68.3030, 1943957340, 1943989769, 20.1198}, // Ushuaia
+  {1950280392, -54.8019, -68.3030, 1950253923, 1950305112, 4.3413}, // Ushuaia
+  {1956587592, -54.8019, -68.3030, 1956556819, 1956618747, 18.3103}, // Ushuaia
+  {1962894792, -54.8019, -68.3030, 1962872628, 1962917960, 3.0061}, // Ushuaia
+  {1969201992, -54.8019, -68.3030, 1969187820, 1969215801, 17.1232}, // Ushuaia
+  {1975509192, -54.8019, -68.3030, 1975493369, 1975525744, 1.4728}, // Ushuaia
+  {1981816392, -54.8019, -68.3030, 1981789958, 1981841082, 15.1289}, // Ushuaia
+  {1988209992, -54.8019, -68.3030, 1988179273, 1988241133, 0.2607}, // Ushuaia
+  {1994517192, -54.8019, -68.3030, 1994495118, 1994540245, 14.3399}, // Ushuaia
+  {2000824392, -54.8019, -68.3030, 2000810282, 2000838150, 28.5741}, // Ushuaia
+  {2007131592, -54.8019, -68.3030, 2007115677, 2007148224, 13.3474}, // Ushuaia
+  {2013438792, -54.8019, -68.3030, 2013412250, 2013463574, 27.1202}, // Ushuaia
+  {2019745992, -54.8019, -68.3030, 2019715256, 2019777137, 10.9068}, // Ushuaia
+  {2026053192, -54.8019, -68.3030, 2026031089, 2026076282, 24.7236}, // Ushuaia
+  {2032360392, -54.8019, -68.3030, 2032346262, 2032374167, 9.5558}, // Ushuaia
+  {2038667592, -54.8019, -68.3030, 2038651707, 2038684199, 23.9290}, // Ushuaia
+  {2044974792, -54.8019, -68.3030, 2044948285, 2044999544, 8.3752}, // Ushuaia
+  {2051281992, -54.8019, -68.3030, 2051251238, 2051313141, 21.8459}, // Ushuaia
+  {2057589192, -54.8019, -68.3030, 2057567060, 2057612319, 5.7245}, // Ushuaia
+  {2063896392, -54.8019, -68.3030, 2063882242, 2063910183, 19.8538}, // Ushuaia
+  {2070203592, -54.8019, -68.3030, 2070187736, 2070220173, 4.9731}, // Ushuaia
+  {2076510792, -54.8019, -68.3030, 2076484320, 2076535515, 19.1429}, // Ushuaia
+  {2082817992, -54.8019, -68.3030, 2082787221, 2082849146, 3.0843}, // Ushuaia
+  {2089125192, -54.8019, -68.3030, 2089103031, 2089148356, 16.4813}, // Ushuaia
+  {2095432392, -54.8019, -68.3030, 2095418222, 2095446200, 0.8860}, // Ushuaia
+  {2101739592, -54.8019, -68.3030, 2101723766, 2101756148, 15.2611}, // Ushuaia
+  {2108046792, -54.8019, -68.3030, 2108020354, 2108071485, 0.1964}, // Ushuaia
+  {2114440392, -54.8019, -68.3030, 2114409675, 2114471532, 15.0406}, // Ushuaia
+  {2120747592, -54.8019, -68.3030, 2120725520, 2120770641, 28.4851}, // Ushuaia
+  {2127054792, -54.8019, -68.3030, 2127040685, 2127068548, 12.4430}, // Ushuaia
+  {2133361992, -54.8019, -68.3030, 2133346075, 2133378627, 26.5839}, // Ushuaia
+  {2139669192, -54.8019, -68.3030, 2139642647, 2139693977, 11.5822}, // Ushuaia
+  {1514771709, -33.8688, 151.2093, 1514746049, 1514797764, 13.8087}, // Sydney
+  {1521078909, -33.8688, 151.2093, 1521057242, 1521101628, 27.2010}, // Sydney
+  {1527386109, -33.8688, 151.2093, 1527367695, 1527404165, 11.5880}, // Sydney
+  {1533693309, -33.8688, 151.2093, 1533674506, 1533712821, 25.9630}, // Sydney
+  {1540000509, -33.8688, 151.2093, 1539976098, 1540023136, 10.9220}, // Sydney
+  {1546307709, -33.8688, 151.2093, 1546282038, 1546333761, 24.7738}, // Sydney
+  {1552614909, -33.8688, 151.2093, 1552593230, 1552637647, 8.4106}, // Sydney
+  {1558922109, -33.8688, 151.2093, 1558903686, 1558940171, 22.1318}, // Sydney
+  {1565229309, -33.8688, 151.2093, 1565210520, 1565248811, 6.9465}, // Sydney
+  {1571536509, -33.8688, 151.2093, 1571512115, 1571559124, 21.3111}, // Sydney
+  {1577843709, -33.8688, 151.2093, 1577818027, 1577869758, 5.8620}, // Sydney
+  {1584150909, -33.8688, 151.2093, 1584129219, 1584173667, 19.4327}, // Sydney
+  {1590458109, -33.8688, 151.2093, 1590439676, 1590476177, 3.3446}, // Sydney
+  {1596765309, -33.8688, 151.2093, 1596746534, 1596784801, 17.3485}, // Sydney
+  {1603072509, -33.8688, 151.2093, 1603048132, 1603095112, 2.2664}, // Sydney
+  {1609466109, -33.8688, 151.2093, 1609440460, 1609492167, 17.4014}, // Sydney
+  {1615773309, -33.8688, 151.2093, 1615751654, 1615796006, 1.6485}, // Sydney
+  {1622080509, -33.8688, 151.2093, 1622062106, 1622098558, 15.2881}, // Sydney
+  {1628387709, -33.8688, 151.2093, 1628368891, 1628407233, 29.0264}, // Sydney
+  {1634694909, -33.8688, 151.2093, 1634670478, 1634717550, 13.6175}, // Sydney
+  {1641002109, -33.8688, 151.2093, 1640976449, 1641028164, 27.7578}, // Sydney
+  {1647309309, -33.8688, 151.2093, 1647287643, 1647332025, 12.3470}, // Sydney
+  {1653616509, -33.8688, 151.2093, 1653598097, 1653634564, 26.2271}, // Sydney
+  {1659923709, -33.8688, 151.2093, 1659904905, 1659943223, 10.3336}, // Sydney
+  {1666230909, -33.8688, 151.2093, 1666206495, 1666253538, 24.1670}, // Sydney
+  {1672538109, -33.8688, 151.2093, 1672512438, 1672564161, 8.6509}, // Sydney
+  {1678845309, -33.8688, 151.2093, 1678823632, 1678868044, 22.7835}, // Sydney
+  {1685152509, -33.8688, 151.2093, 1685134088, 1685170570, 7.4179}, // Sydney
+  {1691459709, -33.8688, 151.2093, 1691440919, 1691479213, 21.3079}, // Sydney
+  {1697766909, -33.8688, 151.2093, 1697742512, 1697789526, 5.3330}, // Sydney
+  {1704074109, -33.8688, 151.2093, 1704048428, 1704100158, 19.0991}, // Sydney
+  {1710381309, -33.8688, 151.2093, 1710359620, 1710404064, 3.7043}, // Sydney
+  {1716688509, -33.8688, 151.2093, 1716670078, 1716706576, 17.9394}, // Sydney
+  {1722995709, -33.8688, 151.2093, 1722976933, 1723015203, 2.6122}, // Sydney
+  {1729302909, -33.8688, 151.2093, 1729278530, 1729325514, 16.2952}, // Sydney
+  {1735696509, -33.8688, 151.2093, 1735670861, 1735722567, 1.1443}, // Sydney
+  {1742003709, -33.8688, 151.2093, 1741982056, 1742026403, 15.0483}, // Sydney
+  {1748310909, -33.8688, 151.2093, 1748292508, 1748328957, 29.2659}, // Sydney
+  {1754618109, -33.8688, 151.2093, 1754599290, 1754637635, 14.2803}, // Sydney
+  {1760925309, -33.8688, 151.2093, 1760900875, 1760947952, 28.2508}, // Sydney
+  {1767232509, -33.8688, 151.2093, 1767206850, 1767258564, 12.0079}, // Sydney
+  {1773539709, -33.8688, 151.2093, 1773518045, 1773562422, 25.5785}, // Sydney
+  {1779846909, -33.8688, 151.2093, 1779828499, 1779864963, 10.2452}, // Sydney
+  {1786154109, -33.8688, 151.2093, 1786135304, 1786173625, 24.6743}, // Sydney
+  {1792461309, -33.8688, 151.2093, 1792436893, 1792483940, 9.4201}, // Sydney
+  {1798768509, -33.8688, 151.2093, 1798742839, 1798794561, 23.0437}, // Sydney
+  {1805075709, -33.8688, 151.2093, 1805054033, 1805098441, 6.6842}, // Sydney
+  {1811382909, -33.8688, 151.2093, 1811364489, 1811400969, 20.6223}, // Sydney
+  {1817690109, -33.8688, 151.2093, 1817671317, 1817709615, 5.6594}, // Sydney
+  {1823997309, -33.8688, 151.2093, 1823972910, 1824019928, 19.9712}, // Sydney
+  {1830304509, -33.8688, 151.2093, 1830278829, 1830330558, 4.2377}, // Sydney
+  {1836611709, -33.8688, 151.2093, 1836590022, 1836634461, 17.6370}, // Sydney
+  {1842918909, -33.8688, 151.2093, 1842900480, 1842936976, 1.7348}, // Sydney
+  {1849226109, -33.8688, 151.2093, 1849207331, 1849245605, 15.9532}, // Sydney
+  {1855533309, -33.8688, 151.2093, 1855508927, 1855555916, 0.9570}, // Sydney
+  {1861926909, -33.8688, 151.2093, 1861901262, 1861952966, 15.9923}, // Sydney
+  {1868234109, -33.8688, 151.2093, 1868212457, 1868256800, 29.6412}, // Sydney
+  {1874541309, -33.8688, 151.2093, 1874522910, 1874559357, 13.5083}, // Sydney
+  {1880848509, -33.8688, 151.2093, 1880829688, 1880868037, 27.4187}, // Sydney
+  {1887155709, -33.8688, 151.2093, 1887131273, 1887178353, 12.2778}, // Sydney
+  {1893462909, -33.8688, 151.2093, 1893437251, 1893488963, 26.4603}, // Sydney
+  {1899770109, -33.8688, 151.2093, 1899748446, 1899792819, 10.8056}, // Sydney
+  {1906077309, -33.8688, 151.2093, 1906058900, 1906095364, 24.4879}, // Sydney
+  {1912384509, -33.8688, 151.2093, 1912365701, 1912404027, 8.6137}, // Sydney
+  {1918691709, -33.8688, 151.2093, 1918667291, 1918714341, 22.6666}, // Sydney
+  {1924998909, -33.8688, 151.2093, 1924973241, 1925024960, 7.3489}, // Sydney
+  {1931306109, -33.8688, 151.2093, 1931284434, 1931328839, 21.4208}, // Sydney
+  {1937613309, -33.8688, 151.2093, 1937594891, 1937631370, 5.7761}, // Sydney
+  {1943920509, -33.8688, 151.2093, 1943901715, 1943940017, 19.5101}, // Sydney
+  {1950227709, -33.8688, 151.2093, 1950203308, 1950250329, 3.7315}, // Sydney
+  {1956534909, -33.8688, 151.2093, 1956509230, 1956560957, 17.7006}, // Sydney
+  {1962842109, -33.8688, 151.2093, 1962820423, 1962864858, 2.3963}, // Sydney
+  {1969149309, -33.8688, 151.2093, 1969130881, 1969167376, 16.5134}, // Sydney
+  {1975456509, -33.8688, 151.2093, 1975437729, 1975476007, 0.8630}, // Sydney
+  {1981763709, -33.8688, 151.2093, 1981739326, 1981786317, 14.5192}, // Sydney
+  {1988157309, -33.8688, 151.2093, 1988131664, 1988183365, 29.2092}, // Sydney
+  {1994464509, -33.8688, 151.2093, 1994442858, 1994487197, 13.7301}, // Sydney
+  {2000771709, -33.8688, 151.2093, 2000753311, 2000789758, 27.9644}, // Sydney
+  {2007078909, -33.8688, 151.2093, 2007060086, 2007098439, 12.7377}, // Sydney
+  {2013386109, -33.8688, 151.2093, 2013361671, 2013408755, 26.5105}, // Sydney
+  {2019693309, -33.8688, 151.2093, 2019667653, 2019719362, 10.2971}, // Sydney
+  {2026000509, -33.8688, 151.2093, 2025978847, 2026023217, 24.1139}, // Sydney
+  {2032307709, -33.8688, 151.2093, 2032289301, 2032325764, 8.9460}, // Sydney
+  {2038614909, -33.8688, 151.2093, 2038596100, 2038634429, 23.3193}, // Sydney
+  {2044922109, -33.8688, 151.2093, 2044897689, 2044944742, 7.7654}, // Sydney
+  {2051229309, -33.8688, 151.2093, 2051203642, 2051255359, 21.2361}, // Sydney
+  {2057536509, -33.8688, 151.2093, 2057514835, 2057559236, 5.1148}, // Sydney
+  {2063843709, -33.8688, 151.2093, 2063825292, 2063861770, 19.2440}, // Sydney
+  {2070150909, -33.8688, 151.2093, 2070132114, 2070170419, 4.3634}, // Sydney
+  {2076458109, -33.8688, 151.2093, 2076433706, 2076480730, 18.5331}, // Sydney
+  {2082765309, -33.8688, 151.2093, 2082739631, 2082791356, 2.4745}, // Sydney
+  {2089072509, -33.8688, 151.2093, 2089050824, 2089095256, 15.8716}, // Sydney
+  {2095379709, -33.8688, 151.2093, 2095361283, 2095397776, 0.2762}, // Sydney
+  {2101686909, -33.8688, 151.2093, 2101668128, 2101706409, 14.6513}, // Sydney
+  {2107994109, -33.8688, 151.2093, 2107969724, 2108016718, 29.0023}, // Sydney
+  {2114387709, -33.8688, 151.2093, 2114362064, 2114413765, 14.4308}, // Sydney
+  {2120694909, -33.8688, 151.2093, 2120673259, 2120717595, 27.8754}, // Sydney
+  {2127002109, -33.8688, 151.2093, 2126983712, 2127020157, 11.8332}, // Sydney
+  {2133309309, -33.8688, 151.2093, 2133290485, 2133328841, 25.9741}, // Sydney
+  {2139616509, -33.8688, 151.2093, 2139592069, 2139639156, 10.9725}, // Sydney
+  {1514843976, 61.2181, -149.9003, 1514834015, 1514854403, 14.6451}, // Anchorage
+  {1521151176, 61.2181, -149.9003, 1521130556, 1521172936, 28.0374}, // Anchorage
+  {1527458376, 61.2181, -149.9003, 1527425079, 1527491435, 12.4244}, // Anchorage
+  {1533765576, 61.2181, -149.9003, 1533736225, 1533795487, 26.7994}, // Anchorage
+  {1540072776, 61.2181, -149.9003, 1540054542, 1540089106, 11.7584}, // Anchorage
+  {1546379976, 61.2181, -149.9003, 1546370025, 1546390379, 25.6103}, // Anchorage
+  {1552687176, 61.2181, -149.9003, 1552666602, 1552708898, 9.2470}, // Anchorage
+  {1558994376, 61.2181, -149.9003, 1558961107, 1559027403, 22.9682}, // Anchorage
+  {1565301576, 61.2181, -149.9003, 1565272187, 1565331529, 7.7830}, // Anchorage
+  {1571608776, 61.2181, -149.9003, 1571590504, 1571625150, 22.1475}, // Anchorage
+  {1577915976, 61.2181, -149.9003, 1577906034, 1577926356, 6.6984}, // Anchorage
+  {1584223176, 61.2181, -149.9003, 1584202647, 1584244860, 20.2692}, // Anchorage
+  {1590530376, 61.2181, -149.9003, 1590497135, 1590563372, 4.1810}, // Anchorage
+  {1596837576, 61.2181, -149.9003, 1596808150, 1596867571, 18.1849}, // Anchorage
+  {1603144776, 61.2181, -149.9003, 1603126465, 1603161193, 3.1028}, // Anchorage
+  {1609538376, 61.2181, -149.9003, 1609528406, 1609548827, 18.2378}, // Anchorage
+  {1615845576, 61.2181, -149.9003, 1615824904, 1615867378, 2.4849}, // Anchorage
+  {1622152776, 61.2181, -149.9003, 1622119445, 1622185872, 16.1246}, // Anchorage
+  {1628459976, 61.2181, -149.9003, 1628430667, 1628489842, 0.3395}, // Anchorage
+  {1634767176, 61.2181, -149.9003, 1634748986, 1634783457, 14.4540}, // Anchorage
+  {1641074376, 61.2181, -149.9003, 1641064416, 1641084803, 28.5943}, // Anchorage
+  {1647381576, 61.2181, -149.9003, 1647360950, 1647403340, 13.1835}, // Anchorage
+  {1653688776, 61.2181, -149.9003, 1653655473, 1653721841, 27.0635}, // Anchorage
+  {1659995976, 61.2181, -149.9003, 1659966630, 1660025883, 11.1700}, // Anchorage
+  {1666303176, 61.2181, -149.9003, 1666284948, 1666319500, 25.0034}, // Anchorage
+  {1672610376, 61.2181, -149.9003, 1672600425, 1672620780, 9.4873}, // Anchorage
+  {1678917576, 61.2181, -149.9003, 1678896995, 1678939302, 23.6200}, // Anchorage
+  {1685224776, 61.2181, -149.9003, 1685191501, 1685257810, 8.2543}, // Anchorage
+  {1691531976, 61.2181, -149.9003, 1691502593, 1691561925, 22.1443}, // Anchorage
+  {1697839176, 61.2181, -149.9003, 1697820910, 1697855543, 6.1694}, // Anchorage
+  {1704146376, 61.2181, -149.9003, 1704136434, 1704156757, 19.9355}, // Anchorage
+  {1710453576, 61.2181, -149.9003, 1710433041, 1710475265, 4.5407}, // Anchorage
+  {1716760776, 61.2181, -149.9003, 1716727530, 1716793779, 18.7758}, // Anchorage
+  {1723067976, 61.2181, -149.9003, 1723038555, 1723097966, 3.4487}, // Anchorage
+  {1729375176, 61.2181, -149.9003, 1729356871, 1729391586, 17.1317}, // Anchorage
+  {1735768776, 61.2181, -149.9003, 1735758805, 1735779228, 1.9807}, // Anchorage
+  {1742075976, 61.2181, -149.9003, 1742055297, 1742097783, 15.8847}, // Anchorage
+  {1748383176, 61.2181, -149.9003, 1748349840, 1748416278, 0.7891}, // Anchorage
+  {1754690376, 61.2181, -149.9003, 1754661074, 1754720236, 15.1168}, // Anchorage
+  {1760997576, 61.2181, -149.9003, 1760979392, 1761013850, 29.0872}, // Anchorage
+  {1767304776, 61.2181, -149.9003, 1767294814, 1767315205, 12.8443}, // Anchorage
+  {1773611976, 61.2181, -149.9003, 1773591343, 1773633746, 26.4150}, // Anchorage
+  {1779919176, 61.2181, -149.9003, 1779885869, 1779952247, 11.0816}, // Anchorage
+  {1786226376, 61.2181, -149.9003, 1786197037, 1786256277, 25.5107}, // Anchorage
+  {1792533576, 61.2181, -149.9003, 1792515354, 1792549893, 10.2566}, // Anchorage
+  {1798840776, 61.2181, -149.9003, 1798830823, 1798851183, 23.8801}, // Anchorage
+  {1805147976, 61.2181, -149.9003, 1805127388, 1805169708, 7.5206}, // Anchorage
+  {1811455176, 61.2181, -149.9003, 1811421898, 1811488215, 21.4588}, // Anchorage
+  {1817762376, 61.2181, -149.9003, 1817733000, 1817792318, 6.4958}, // Anchorage
+  {1824069576, 61.2181, -149.9003, 1824051315, 1824085937, 20.8077}, // Anchorage
+  {1830376776, 61.2181, -149.9003, 1830366830, 1830387160, 5.0741}, // Anchorage
+  {1836683976, 61.2181, -149.9003, 1836663434, 1836705670, 18.4734}, // Anchorage
+  {1842991176, 61.2181, -149.9003, 1842957927, 1843024183, 2.5712}, // Anchorage
+  {1849298376, 61.2181, -149.9003, 1849268963, 1849328359, 16.7896}, // Anchorage
+  {1855605576, 61.2181, -149.9003, 1855587277, 1855621980, 1.7934}, // Anchorage
+  {1861999176, 61.2181, -149.9003, 1861989201, 1862009633, 16.8287}, // Anchorage
+  {1868306376, 61.2181, -149.9003, 1868285690, 1868328188, 0.7359}, // Anchorage
+  {1874613576, 61.2181, -149.9003, 1874580238, 1874646681, 14.3447}, // Anchorage
+  {1880920776, 61.2181, -149.9003, 1880891481, 1880950629, 28.2551}, // Anchorage
+  {1887227976, 61.2181, -149.9003, 1887209797, 1887244245, 13.1142}, // Anchorage
+  {1893535176, 61.2181, -149.9003, 1893525210, 1893545610, 27.2967}, // Anchorage
+  {1899842376, 61.2181, -149.9003, 1899821736, 1899864151, 11.6420}, // Anchorage
+  {1906149576, 61.2181, -149.9003, 1906116267, 1906182649, 25.3243}, // Anchorage
+  {1912456776, 61.2181, -149.9003, 1912427444, 1912486670, 9.4502}, // Anchorage
+  {1918763976, 61.2181, -149.9003, 1918745758, 1918780288, 23.5030}, // Anchorage
+  {1925071176, 61.2181, -149.9003, 1925061218, 1925081588, 8.1854}, // Anchorage
+  {1931378376, 61.2181, -149.9003, 1931357782, 1931400113, 22.2572}, // Anchorage
+  {1937685576, 61.2181, -149.9003, 1937652297, 1937718617, 6.6125}, // Anchorage
+  {1943992776, 61.2181, -149.9003, 1943963407, 1944022711, 20.3465}, // Anchorage
+  {1950299976, 61.2181, -149.9003, 1950281719, 1950316332, 4.5680}, // Anchorage
+  {1956607176, 61.2181, -149.9003, 1956597226, 1956617565, 18.5370}, // Anchorage
+  {1962914376, 61.2181, -149.9003, 1962893828, 1962936075, 3.2328}, // Anchorage
+  {1969221576, 61.2181, -149.9003, 1969188326, 1969254585, 17.3498}, // Anchorage
+  {1975528776, 61.2181, -149.9003, 1975499369, 1975558753, 1.6994}, // Anchorage
+  {1981835976, 61.2181, -149.9003, 1981817680, 1981852376, 15.3556}, // Anchorage
+  {1988229576, 61.2181, -149.9003, 1988219597, 1988240037, 0.4873}, // Anchorage
+  {1994536776, 61.2181, -149.9003, 1994516085, 1994558593, 14.5665}, // Anchorage
+  {2000843976, 61.2181, -149.9003, 2000810637, 2000877084, 28.8008}, // Anchorage
+  {2007151176, 61.2181, -149.9003, 2007121887, 2007181023, 13.5741}, // Anchorage
+  {2013458376, 61.2181, -149.9003, 2013440201, 2013474641, 27.3469}, // Anchorage
+  {2019765576, 61.2181, -149.9003, 2019755606, 2019776014, 11.1335}, // Anchorage
+  {2026072776, 61.2181, -149.9003, 2026052131, 2026094554, 24.9503}, // Anchorage
+  {2032379976, 61.2181, -149.9003, 2032346666, 2032413052, 9.7824}, // Anchorage
+  {2038687176, 61.2181, -149.9003, 2038657849, 2038717065, 24.1557}, // Anchorage
+  {2044994376, 61.2181, -149.9003, 2044976162, 2045010684, 8.6018}, // Anchorage
+  {2051301576, 61.2181, -149.9003, 2051291615, 2051311991, 22.0726}, // Anchorage
+  {2057608776, 61.2181, -149.9003, 2057588177, 2057630516, 5.9512}, // Anchorage
+  {2063915976, 61.2181, -149.9003, 2063882695, 2063949020, 20.0805}, // Anchorage
+  {2070223176, 61.2181, -149.9003, 2070193812, 2070253106, 5.1998}, // Anchorage
+  {2076530376, 61.2181, -149.9003, 2076512123, 2076546728, 19.3696}, // Anchorage
+  {2082837576, 61.2181, -149.9003, 2082827624, 2082847968, 3.3110}, // Anchorage
+  {2089144776, 61.2181, -149.9003, 2089124223, 2089166478, 16.7080}, // Anchorage
+  {2095451976, 61.2181, -149.9003, 2095418724, 2095484989, 1.1127}, // Anchorage
+  {2101759176, 61.2181, -149.9003, 2101729774, 2101789148, 15.4877}, // Anchorage
+  {2108066376, 61.2181, -149.9003, 2108048084, 2108082771, 0.4231}, // Anchorage
+  {2114459976, 61.2181, -149.9003, 2114449996, 2114470439, 15.2672}, // Anchorage
+  {2120767176, 61.2181, -149.9003, 2120746480, 2120788996, 28.7118}, // Anchorage
+  {2127074376, 61.2181, -149.9003, 2127041034, 2127107488, 12.6697}, // Anchorage
+  {2133381576, 61.2181, -149.9003, 2133352291, 2133411419, 26.8105}, // Anchorage
+  {2139688776, 61.2181, -149.9003, 2139670605, 2139705036, 11.8089}, // Anchorage
+  {1514783083, 1.3521, 103.8198, 1514761602, 1514804975, 13.9403}, // Singapore
+  {1521090283, 1.3521, 103.8198, 1521069039, 1521112607, 27.3326}, // Singapore
+  {1527397483, 1.3521, 103.8198, 1527375369, 1527419254, 11.7197}, // Singapore
+  {1533704683, 1.3521, 103.8198, 1533683124, 1533726925, 26.0946}, // Singapore
+  {1540011883, 1.3521, 103.8198, 1539989231, 1540032714, 11.0536}, // Singapore
+  {1546319083, 1.3521, 103.8198, 1546297595, 1546340968, 24.9055}, // Singapore
+  {1552626283, 1.3521, 103.8198, 1552605044, 1552648610, 8.5422}, // Singapore
+  {1558933483, 1.3521, 103.8198, 1558911367, 1558955252, 22.2635}, // Singapore
+  {1565240683, 1.3521, 103.8198, 1565219126, 1565262927, 7.0782}, // Singapore
+  {1571547883, 1.3521, 103.8198, 1571525233, 1571568717, 21.4427}, // Singapore
+  {1577855083, 1.3521, 103.8198, 1577833588, 1577876961, 5.9936}, // Singapore
+  {1584162283, 1.3521, 103.8198, 1584141048, 1584184614, 19.5644}, // Singapore
+  {1590469483, 1.3521, 103.8198, 1590447366, 1590491250, 3.4762}, // Singapore
+  {1596776683, 1.3521, 103.8198, 1596755127, 1596798930, 17.4801}, // Singapore
+  {1603083883, 1.3521, 103.8198, 1603061235, 1603104720, 2.3980}, // Singapore
+  {1609477483, 1.3521, 103.8198, 1609456009, 1609499383, 17.5330}, // Singapore
+  {1615784683, 1.3521, 103.8198, 1615763434, 1615807002, 1.7801}, // Singapore
+  {1622091883, 1.3521, 103.8198, 1622069770, 1622113657, 15.4198}, // Singapore
+  {1628399083, 1.3521, 103.8198, 1628377523, 1628421322, 29.1580}, // Singapore
+  {1634706283, 1.3521, 103.8198, 1634683628, 1634727110, 13.7492}, // Singapore
+  {1641013483, 1.3521, 103.8198, 1640992002, 1641035376, 27.8895}, // Singapore
+  {1647320683, 1.3521, 103.8198, 1647299438, 1647343006, 12.4787}, // Singapore
+  {1653627883, 1.3521, 103.8198, 1653605769, 1653649655, 26.3588}, // Singapore
+  {1659935083, 1.3521, 103.8198, 1659913525, 1659957325, 10.4652}, // Singapore
+  {1666242283, 1.3521, 103.8198, 1666219630, 1666263113, 24.2987}, // Singapore
+  {1672549483, 1.3521, 103.8198, 1672527996, 1672571368, 8.7826}, // Singapore
+  {1678856683, 1.3521, 103.8198, 1678835443, 1678879009, 22.9152}, // Singapore
+  {1685163883, 1.3521, 103.8198, 1685141768, 1685185653, 7.5495}, // Singapore
+  {1691471083, 1.3521, 103.8198, 1691449526, 1691493328, 21.4395}, // Singapore
+  {1697778283, 1.3521, 103.8198, 1697755632, 1697799116, 5.4646}, // Singapore
+  {1704085483, 1.3521, 103.8198, 1704063989, 1704107361, 19.2307}, // Singapore
+  {1710392683, 1.3521, 103.8198, 1710371448, 1710415013, 3.8359}, // Singapore
+  {1716699883, 1.3521, 103.8198, 1716677767, 1716721651, 18.0710}, // Singapore
+  {1723007083, 1.3521, 103.8198, 1722985528, 1723029330, 2.7439}, // Singapore
+  {1729314283, 1.3521, 103.8198, 1729291635, 1729335119, 16.4269}, // Singapore
+  {1735707883, 1.3521, 103.8198, 1735686410, 1735729783, 1.2759}, // Singapore
+  {1742015083, 1.3521, 103.8198, 1741993833, 1742037402, 15.1800}, // Singapore
+  {1748322283, 1.3521, 103.8198, 1748300171, 1748344057, 0.0843}, // Singapore
+  {1754629483, 1.3521, 103.8198, 1754607924, 1754651723, 14.4120}, // Singapore
+  {1760936683, 1.3521, 103.8198, 1760914028, 1760957510, 28.3824}, // Singapore
+  {1767243883, 1.3521, 103.8198, 1767222403, 1767265776, 12.1395}, // Singapore
+  {1773551083, 1.3521, 103.8198, 1773529838, 1773573405, 25.7102}, // Singapore
+  {1779858283, 1.3521, 103.8198, 1779836170, 1779880055, 10.3768}, // Singapore
+  {1786165483, 1.3521, 103.8198, 1786143925, 1786187725, 24.8059}, // Singapore
+  {1792472683, 1.3521, 103.8198, 1792450030, 1792493513, 9.5518}, // Singapore
+  {1798779883, 1.3521, 103.8198, 1798758396, 1798801769, 23.1753}, // Singapore
+  {1805087083, 1.3521, 103.8198, 1805065842, 1805109409, 6.8158}, // Singapore
+  {1811394283, 1.3521, 103.8198, 1811372168, 1811416054, 20.7540}, // Singapore
+  {1817701483, 1.3521, 103.8198, 1817679927, 1817723728, 5.7910}, // Singapore
+  {1824008683, 1.3521, 103.8198, 1823986032, 1824029516, 20.1029}, // Singapore
+  {1830315883, 1.3521, 103.8198, 1830294389, 1830337762, 4.3693}, // Singapore
+  {1836623083, 1.3521, 103.8198, 1836601847, 1836645412, 17.7686}, // Singapore
+  {1842930283, 1.3521, 103.8198, 1842908167, 1842952052, 1.8664}, // Singapore
+  {1849237483, 1.3521, 103.8198, 1849215928, 1849259730, 16.0848}, // Singapore
+  {1855544683, 1.3521, 103.8198, 1855522034, 1855565519, 1.0887}, // Singapore
+  {1861938283, 1.3521, 103.8198, 1861916810, 1861960183, 16.1239}, // Singapore
+  {1868245483, 1.3521, 103.8198, 1868224232, 1868267801, 0.0312}, // Singapore
+  {1874552683, 1.3521, 103.8198, 1874530571, 1874574458, 13.6400}, // Singapore
+  {1880859883, 1.3521, 103.8198, 1880838324, 1880882123, 27.5503}, // Singapore
+  {1887167083, 1.3521, 103.8198, 1887144428, 1887187909, 12.4094}, // Singapore
+  {1893474283, 1.3521, 103.8198, 1893452803, 1893496176, 26.5919}, // Singapore
+  {1899781483, 1.3521, 103.8198, 1899760237, 1899803805, 10.9372}, // Singapore
+  {1906088683, 1.3521, 103.8198, 1906066570, 1906110456, 24.6195}, // Singapore
+  {1912395883, 1.3521, 103.8198, 1912374325, 1912418125, 8.7454}, // Singapore
+  {1918703083, 1.3521, 103.8198, 1918680430, 1918723912, 22.7982}, // Singapore
+  {1925010283, 1.3521, 103.8198, 1924988796, 1925032169, 7.4806}, // Singapore
+  {1931317483, 1.3521, 103.8198, 1931296241, 1931339808, 21.5525}, // Singapore
+  {1937624683, 1.3521, 103.8198, 1937602569, 1937646454, 5.9078}, // Singapore
+  {1943931883, 1.3521, 103.8198, 1943910327, 1943954128, 19.6417}, // Singapore
+  {1950239083, 1.3521, 103.8198, 1950216432, 1950259915, 3.8632}, // Singapore
+  {1956546283, 1.3521, 103.8198, 1956524789, 1956568162, 17.8322}, // Singapore
+  {1962853483, 1.3521, 103.8198, 1962832246, 1962875812, 2.5280}, // Singapore
+  {1969160683, 1.3521, 103.8198, 1969138568, 1969182453, 16.6451}, // Singapore
+  {1975467883, 1.3521, 103.8198, 1975446328, 1975490130, 0.9947}, // Singapore
+  {1981775083, 1.3521, 103.8198, 1981752434, 1981795918, 14.6508}, // Singapore
+  {1988168683, 1.3521, 103.8198, 1988147210, 1988190583, 29.3409}, // Singapore
+  {1994475883, 1.3521, 103.8198, 1994454631, 1994498200, 13.8618}, // Singapore
+  {2000783083, 1.3521, 103.8198, 2000760972, 2000804859, 28.0960}, // Singapore
+  {2007090283, 1.3521, 103.8198, 2007068724, 2007112523, 12.8693}, // Singapore
+  {2013397483, 1.3521, 103.8198, 2013374827, 2013418309, 26.6421}, // Singapore
+  {2019704683, 1.3521, 103.8198, 2019683203, 2019726576, 10.4287}, // Singapore
+  {2026011883, 1.3521, 103.8198, 2025990636, 2026034204, 24.2455}, // Singapore
+  {2032319083, 1.3521, 103.8198, 2032296971, 2032340857, 9.0777}, // Singapore
+  {2038626283, 1.3521, 103.8198, 2038604725, 2038648525, 23.4509}, // Singapore
+  {2044933483, 1.3521, 103.8198, 2044910829, 2044954312, 7.8970}, // Singapore
+  {2051240683, 1.3521, 103.8198, 2051219196, 2051262569, 21.3678}, // Singapore
+  {2057547883, 1.3521, 103.8198, 2057526641, 2057570207, 5.2464}, // Singapore
+  {2063855083, 1.3521, 103.8198, 2063832970, 2063876855, 19.3757}, // Singapore
+  {2070162283, 1.3521, 103.8198, 2070140727, 2070184528, 4.4950}, // Singapore
+  {2076469483, 1.3521, 103.8198, 2076446832, 2076490315, 18.6648}, // Singapore
+  {2082776683, 1.3521, 103.8198, 2082755189, 2082798562, 2.6062}, // Singapore
+  {2089083883, 1.3521, 103.8198, 2089062645, 2089106211, 16.0032}, // Singapore
+  {2095391083, 1.3521, 103.8198, 2095368969, 2095412853, 0.4079}, // Singapore
+  {2101698283, 1.3521, 103.8198, 2101676728, 2101720530, 14.7830}, // Singapore
+  {2108005483, 1.3521, 103.8198, 2107982834, 2108026318, 29.1339}, // Singapore
+  {2114399083, 1.3521, 103.8198, 2114377610, 2114420984, 14.5625}, // Singapore
+  {2120706283, 1.3521, 103.8198, 2120685031, 2120728600, 28.0070}, // Singapore
+  {2127013483, 1.3521, 103.8198, 2126991373, 2127035260, 11.9649}, // Singapore
+  {2133320683, 1.3521, 103.8198, 2133299124, 2133342923, 26.1057}, // Singapore
+  {2139627883, 1.3521, 103.8198, 2139605227, 2139648709, 11.1041}, // Singapore
+};
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "AssetStore.h"
+#include "WeatherSnapshot.h"
+
+typedef enum WeatherIcon : uint8_t {
+  ICON_UNKNOWN,
+  ICON_THUNDERSTORM,
+  ICON_DRIZZLE,
+  ICON_LIGHT_RAIN,
+  ICON_EXTREME_RAIN,
+  ICON_RAIN,
+  ICON_SLEET,
+  ICON_SNOW,
+  ICON_FOG,
+  ICON_CLEAR_DAY,
+  ICON_CLEAR_NIGHT,
+  ICON_PARTLY_CLOUDY_DAY,
+  ICON_PARTLY_CLOUDY_NIGHT,
+  ICON_CLOUDY,
+  WEATHER_ICON_COUNT
+} WeatherIcon;
+
+typedef struct WeatherIconAssets {
+  AssetId large;
+  AssetId small;
+} WeatherIconAssets;
+
+// scripts/pack_assets.py fails the build if one of the names used with this macro is missing in
+// either of the icon sets
+#define WEATHER_ICON(name) \
+  {assetId("/weather/" name ".bmp"), assetId("/weather-small/" name ".bmp")}
+
+// indexed by WeatherIcon, hashed at compile time
+constexpr WeatherIconAssets WEATHER_ICON_ASSETS[] = {
+  WEATHER_ICON("unknown"),
+  WEATHER_ICON("thunderstorm"),
+  WEATHER_ICON("drizzle"),
+  WEATHER_ICON("light-rain"),
+  WEATHER_ICON("extreme-rain"),
+  WEATHER_ICON("rain"),
+  WEATHER_ICON("sleet"),
+  WEATHER_ICON("snow"),
+  WEATHER_ICON("fog"),
+  WEATHER_ICON("clear-day"),
+  WEATHER_ICON("clear-night"),
+  WEATHER_ICON("partly-cloudy-day"),
+  WEATHER_ICON("partly-cloudy-night"),
+  WEATHER_ICON("cloudy"),
+};
+static_assert(sizeof(WEATHER_ICON_ASSETS) / sizeof(WEATHER_ICON_ASSETS[0]) == WEATHER_ICON_COUNT,
+              "WEATHER_ICON_ASSETS must have an entry for every WeatherIcon");
+
+typedef struct WeatherIconRange {
+  uint16_t first;
+  uint16_t last;
+  WeatherIcon day;
+  WeatherIcon night;
+} WeatherIconRange;
+
+// Weather condition codes: https://openweathermap.org/weather-conditions#Weather-Condition-Codes-2
+// The first range a code falls into wins, single codes thus go before the group they belong to.
+constexpr WeatherIconRange WEATHER_ICON_RANGES[] = {
+  {200, 299, ICON_THUNDERSTORM, ICON_THUNDERSTORM},
+  {300, 399, ICON_DRIZZLE, ICON_DRIZZLE},
+  {500, 500, ICON_LIGHT_RAIN, ICON_LIGHT_RAIN},
+  {504, 504, ICON_EXTREME_RAIN, ICON_EXTREME_RAIN},
+  {511, 511, ICON_SLEET, ICON_SLEET},
+  {500, 599, ICON_RAIN, ICON_RAIN},
+  {611, 616, ICON_SLEET, ICON_SLEET},
+  {600, 699, ICON_SNOW, ICON_SNOW},
+  {700, 799, ICON_FOG, ICON_FOG},
+  // only the 8xx group has night versions of the icons
+  {800, 800, ICON_CLEAR_DAY, ICON_CLEAR_NIGHT},
+  {801, 801, ICON_PARTLY_CLOUDY_DAY, ICON_PARTLY_CLOUDY_NIGHT},
+  {802, 803, ICON_PARTLY_CLOUDY_DAY, ICON_CLOUDY},
+  {800, 899, ICON_CLOUDY, ICON_CLOUDY},
+};
+constexpr uint8_t WEATHER_ICON_RANGE_COUNT =
+    sizeof(WEATHER_ICON_RANGES) / sizeof(WEATHER_ICON_RANGES[0]);
+
+/**
+ * @param code OpenWeatherMap condition code
+ * @param night whether to use the night version of the icon if there is one
+ */
+constexpr WeatherIcon weatherIcon(uint16_t code, bool night, uint8_t range = 0) {
+  return range == WEATHER_ICON_RANGE_COUNT ? ICON_UNKNOWN
+         : code >= WEATHER_ICON_RANGES[range].first && code <= WEATHER_ICON_RANGES[range].last
+           ? (night ? WEATHER_ICON_RANGES[range].night : WEATHER_ICON_RANGES[range].day)
+           : weatherIcon(code, night, range + 1);
+}
+
+constexpr bool allConditionsHaveIcons(uint8_t i = 0) {
+  return i == OWM_CONDITION_COUNT ||
+         (weatherIcon(OWM_CONDITION_CODES[i], false) != ICON_UNKNOWN &&
+          weatherIcon(OWM_CONDITION_CODES[i], true) != ICON_UNKNOWN &&
+          allConditionsHaveIcons(i + 1));
+}
+static_assert(allConditionsHaveIcons(), "every OpenWeatherMap condition code needs an icon");
+static_assert(weatherIcon(504, false) == ICON_EXTREME_RAIN, "504 is extreme rain");
+static_assert(weatherIcon(800, true) == ICON_CLEAR_NIGHT, "800 has a night icon");
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "settings.h"
+
+// number of entries in ScreenLayout::separators, unused ones have a width of 0
+#define LAYOUT_SEPARATORS 3
+
+typedef enum Anchor : uint8_t {
+  ANCHOR_LEFT,
+  ANCHOR_CENTER,
+  ANCHOR_RIGHT
+} Anchor;
+
+// Position of a text or image relative to the left edge, the center or the right edge and the top
+// of the region of its widget. Texts are centered on it, except for the time.
+typedef struct Slot {
+  Anchor anchor;
+  int16_t dx;
+  int16_t dy;
+  // 0 for images
+  uint8_t fontSize;
+} Slot;
+
+typedef struct LayoutPoint {
+  int16_t x;
+  int16_t y;
+} LayoutPoint;
+
+typedef struct HorizontalLine {
+  int16_t x;
+  int16_t y;
+  int16_t width;
+} HorizontalLine;
+
+typedef struct TimeLayout {
+  RectangleDef region;
+  Slot date;
+  // left edge of the time string, see UI_TIME_WIDTH
+  Slot time;
+} TimeLayout;
+
+typedef struct CurrentWeatherLayout {
+  RectangleDef region;
+  Slot icon;
+  Slot description;
+  Slot temperature;
+  Slot humidity;
+  Slot pressure;
+  Slot windIcon;
+  Slot windSpeed;
+  // name of the displayed location, only with more than one
+  Slot location;
+} CurrentWeatherLayout;
+
+// The region is split into one column per day, the slots are relative to the column. The forecast
+// chart uses the whole region instead.
+typedef struct ForecastLayout {
+  RectangleDef region;
+  Slot weekday;
+  Slot temperatures;
+  Slot icon;
+} ForecastLayout;
+
+typedef struct AstroLayout {
+  RectangleDef region;
+  Slot sunLabel;
+  Slot sunRise;
+  Slot sunSet;
+  Slot moonLabel;
+  Slot moonRise;
+  Slot moonSet;
+  Slot moonIcon;
+  Slot moonPhase;
+} AstroLayout;
+
+// relative to the whole screen, below the logo
+typedef struct ProgressLayout {
+  Slot text;
+  RectangleDef bar;
+  Slot appName;
+  Slot version;
+} ProgressLayout;
+
+typedef struct ScreenLayout {
+  RectangleDef screen;
+  TimeLayout time;
+  CurrentWeatherLayout current;
+  ForecastLayout forecast;
+  AstroLayout astro;
+  ProgressLayout progress;
+  HorizontalLine separators[LAYOUT_SEPARATORS];
+} ScreenLayout;
+
+// Humidity, pressure and wind speed move up to make room for the location name, but only if
+// there's one to show.
+constexpr int16_t belowLocation(int16_t single, int16_t several) {
+  return LOCATION_COUNT > 1 ? several : single;
+}
+
+// Widgets stacked from top to bottom.
+constexpr ScreenLayout PORTRAIT_LAYOUT = {
+  {0, 0, 320, 480},
+  {{0, 0, 320, 88}, {ANCHOR_CENTER, 0, 10, 16}, {ANCHOR_CENTER, 0, 25, 48}},
+  {
+    // below the separator at y=90, drawWeather() clears the region without redrawing it
+    {0, 91, 320, 139},
+    {ANCHOR_LEFT, 5, 34, 0},
+    {ANCHOR_CENTER, 0, 4, 24},
+    // slightly shifted to the right to find better balance due to the ° symbol
+    {ANCHOR_CENTER, 10, 29, 48},
+    {ANCHOR_CENTER, 0, belowLocation(87, 81), 18},
+    {ANCHOR_CENTER, 0, belowLocation(109, 101), 18},
+    {ANCHOR_RIGHT, -80, 34, 0},
+    {ANCHOR_RIGHT, -43, belowLocation(109, 101), 18},
+    {ANCHOR_CENTER, 0, 121, 14}
+  },
+  {{0, 232, 320, 122}, {ANCHOR_CENTER, 0, 3, 24}, {ANCHOR_CENTER, 0, 33, 18},
+   {ANCHOR_CENTER, -25, 63, 0}},
+  {
+    {0, 357, 320, 123},
+    {ANCHOR_LEFT, 60, 8, 24},
+    {ANCHOR_LEFT, 60, 43, 18},
+    {ANCHOR_LEFT, 60, 68, 18},
+    {ANCHOR_RIGHT, -60, 8, 24},
+    {ANCHOR_RIGHT, -60, 43, 18},
+    {ANCHOR_RIGHT, -60, 68, 18},
+    {ANCHOR_CENTER, -37, 8, 0},
+    {ANCHOR_CENTER, 0, 98, 14}
+  },
+  {{ANCHOR_CENTER, 0, 210, 24}, {50, 260, 220, 15}, {ANCHOR_CENTER, 0, 430, 16},
+   {ANCHOR_CENTER, 0, 450, 16}},
+  {{10, 90, 290}, {10, 230, 290}, {10, 355, 290}}
+};
+
+// Time and current weather across the full width, the forecast and sun & moon side by side below.
+constexpr ScreenLayout LANDSCAPE_LAYOUT = {
+  {0, 0, 480, 320},
+  {{0, 0, 480, 70}, {ANCHOR_LEFT, 100, 28, 16}, {ANCHOR_RIGHT, -150, 10, 48}},
+  {
+    {0, 72, 480, 125},
+    {ANCHOR_LEFT, 5, 22, 0},
+    {ANCHOR_CENTER, 0, 2, 24},
+    {ANCHOR_CENTER, 10, 27, 48},
+    {ANCHOR_CENTER, 0, belowLocation(80, 74), 18},
+    {ANCHOR_CENTER, 0, belowLocation(102, 92), 18},
+    {ANCHOR_RIGHT, -80, 22, 0},
+    {ANCHOR_RIGHT, -43, belowLocation(102, 92), 18},
+    {ANCHOR_CENTER, 0, 110, 14}
+  },
+  {{0, 199, 280, 121}, {ANCHOR_CENTER, 0, 3, 24}, {ANCHOR_CENTER, 0, 33, 18},
+   {ANCHOR_CENTER, -25, 63, 0}},
+  {
+    {280, 199, 200, 121},
+    {ANCHOR_LEFT, 35, 6, 20},
+    {ANCHOR_LEFT, 35, 40, 16},
+    {ANCHOR_LEFT, 35, 62, 16},
+    {ANCHOR_RIGHT, -35, 6, 20},
+    {ANCHOR_RIGHT, -35, 40, 16},
+    {ANCHOR_RIGHT, -35, 62, 16},
+    {ANCHOR_CENTER, -37, 6, 0},
+    {ANCHOR_CENTER, 0, 95, 14}
+  },
+  {{ANCHOR_CENTER, 0, 150, 24}, {90, 200, 300, 15}, {ANCHOR_CENTER, 0, 270, 16},
+   {ANCHOR_CENTER, 0, 290, 16}},
+  {{10, 70, 460}, {10, 197, 460}, {0, 0, 0}}
+};
+
+// TFT_ROTATION 2 is portrait, 3 landscape
+constexpr const ScreenLayout &LAYOUT = TFT_ROTATION % 2 == 0 ? PORTRAIT_LAYOUT : LANDSCAPE_LAYOUT;
+static_assert(TFT_ROTATION % 2 == TOUCH_ROTATION % 2,
+              "TFT_ROTATION and TOUCH_ROTATION must both be portrait or both landscape");
+
+/**
+ * Resolves a slot to display coordinates, at compile time since all layouts are constant.
+ */
+constexpr LayoutPoint place(const RectangleDef &region, const Slot &slot) {
+  return {(int16_t)(region.x + slot.dx +
+                    (slot.anchor == ANCHOR_LEFT ? 0
+                     : slot.anchor == ANCHOR_CENTER ? region.width / 2
+                     : region.width)),
+          (int16_t)(region.y + slot.dy)};
+}
+
+// Region of the column of a day in the forecast.
+constexpr RectangleDef forecastColumn(const RectangleDef &region, uint8_t day, uint8_t days) {
+  return {(uint16_t)(region.x + region.width * day / days), region.y,
+          (uint16_t)(region.width / days), region.height};
+}
+
+constexpr bool contains(const RectangleDef &outer, const RectangleDef &inner) {
+  return inner.x + inner.width <= outer.x + outer.width &&
+         inner.y + inner.height <= outer.y + outer.height;
+}
+
+constexpr bool regionsFit(const ScreenLayout &layout) {
+  return contains(layout.screen, layout.time.region) &&
+         contains(layout.screen, layout.current.region) &&
+         contains(layout.screen, layout.forecast.region) &&
+         contains(layout.screen, layout.astro.region) &&
+         contains(layout.screen, layout.progress.bar);
+}
+static_assert(regionsFit(PORTRAIT_LAYOUT), "portrait regions must fit the screen");
+static_assert(regionsFit(LANDSCAPE_LAYOUT), "landscape regions must fit the screen");
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <time.h>
+
+// the window of the cached UTC offset is searched this far for DST transitions
+#define LOCAL_CLOCK_FORWARD_SECONDS (366 * 86400L)
+#define LOCAL_CLOCK_BACKWARD_SECONDS (7 * 86400L)
+// transitions of real time zones are months apart, searching in steps of a week misses none
+#define LOCAL_CLOCK_SEARCH_STEP (7 * 86400L)
+// getLocalNow() considers the clock not set before 2016-01-01, like getLocalTime() does
+#define LOCAL_CLOCK_MIN_VALID 1451606400L
+
+/**
+ * The UTC offset of the timezone from validFrom until before nextTransition. Within that window
+ * local time is UTC plus the offset, only leaving it evaluates the POSIX TZ rules (newlib) again.
+ */
+typedef struct LocalClock {
+  int32_t utcOffset;
+  int isDst;
+  time_t validFrom;
+  time_t nextTransition;
+  // local date fields of the day getLocalNow() last ran on, recomputed at midnight
+  int32_t day;
+  struct tm date;
+  // counts setTimezone() calls, a window calculated for an earlier zone isn't stored
+  uint32_t zone;
+} LocalClock;
+
+// empty window until the first refresh, shared by all tasks: only accessed through
+// readLocalClock() and storeLocalClock()
+LocalClock localClock = {0, 0, 0, 0, -1, {}, 0};
+// held for copies of localClock only, never while calculating
+portMUX_TYPE localClockMux = portMUX_INITIALIZER_UNLOCKED;
+
+LocalClock readLocalClock() {
+  portENTER_CRITICAL(&localClockMux);
+  LocalClock clock = localClock;
+  portEXIT_CRITICAL(&localClockMux);
+  return clock;
+}
+
+// Publishes a window or date calculated from a copy, unless the timezone changed meanwhile.
+void storeLocalClock(const LocalClock *clock) {
+  portENTER_CRITICAL(&localClockMux);
+  if (clock->zone == localClock.zone) localClock = *clock;
+  portEXIT_CRITICAL(&localClockMux);
+}
+
+int32_t utcOffsetAt(time_t timestamp, int *isDst) {
+  struct tm local, utc;
+  localtime_r(&timestamp, &local);
+  gmtime_r(&timestamp, &utc);
+  if (isDst != nullptr) *isDst = local.tm_isdst;
+  // the dates are at most a day apart
+  int32_t days = local.tm_year != utc.tm_year ? (local.tm_year > utc.tm_year ? 1 : -1)
+                                              : local.tm_yday - utc.tm_yday;
+  return ((days * 24 + local.tm_hour - utc.tm_hour) * 60 + local.tm_min - utc.tm_min) * 60 +
+         local.tm_sec - utc.tm_sec;
+}
+
+/**
+ * Searches from `from` towards `to` for a change of the UTC offset.
+ *
+ * @return searching forward the first second with another offset, backward the last second with
+ *         the offset of `from`, `to` if the offset doesn't change
+ */
+time_t findOffsetChange(time_t from, time_t to) {
+  int32_t offset = utcOffsetAt(from, nullptr);
+  long step = to > from ? LOCAL_CLOCK_SEARCH_STEP : -LOCAL_CLOCK_SEARCH_STEP;
+  time_t same = from;
+  while (same != to) {
+    time_t other = (step > 0 ? to - same : same - to) > LOCAL_CLOCK_SEARCH_STEP ? same + step : to;
+    if (utcOffsetAt(other, nullptr) != offset) {
+      // bisect down to the second
+      while ((step > 0 ? other - same : same - other) > 1) {
+        time_t middle = same + (other - same) / 2;
+        if (utcOffsetAt(middle, nullptr) == offset) {
+          same = middle;
+        } else {
+          other = middle;
+        }
+      }
+      return step > 0 ? other : same;
+    }
+    same = other;
+  }
+  return to;
+}
+
+void refreshLocalClock(LocalClock *clock, time_t now) {
+  clock->utcOffset = utcOffsetAt(now, &clock->isDst);
+  clock->validFrom = findOffsetChange(now, now - LOCAL_CLOCK_BACKWARD_SECONDS);
+  clock->nextTransition = findOffsetChange(now, now + LOCAL_CLOCK_FORWARD_SECONDS);
+  clock->day = -1;
+  log_d("UTC offset %d s until %ld.", clock->utcOffset, (long)clock->nextTransition);
+}
+
+bool isInLocalClockWindow(const LocalClock *clock, time_t timestamp) {
+  return timestamp >= clock->validFrom && timestamp < clock->nextTransition;
+}
+
+/**
+ * Drop-in for localtime_r(), fast for timestamps within the window of the cached offset (about a
+ * week back to the next DST transition). Doesn't move the window, getLocalNow() does.
+ */
+struct tm *toLocalTime(time_t timestamp, struct tm *result) {
+  LocalClock clock = readLocalClock();
+  if (!isInLocalClockWindow(&clock, timestamp)) return localtime_r(&timestamp, result);
+  time_t local = timestamp + clock.utcOffset;
+  gmtime_r(&local, result);
+  result->tm_isdst = clock.isDst;
+  return result;
+}
+
+/**
+ * Local time at `now`, moving the window of the cached offset if needed. Only the time of the day
+ * is calculated unless the date changed since the last call.
+ */
+struct tm *updateLocalClock(time_t now, struct tm *result) {
+  // calculated on a copy, any task may get here
+  LocalClock clock = readLocalClock();
+  bool changed = !isInLocalClockWindow(&clock, now);
+  if (changed) refreshLocalClock(&clock, now);
+  time_t local = now + clock.utcOffset;
+  int32_t day = local / 86400;
+  if (day != clock.day) {
+    gmtime_r(&local, &clock.date);
+    clock.date.tm_isdst = clock.isDst;
+    clock.day = day;
+    changed = true;
+  }
+  if (changed) storeLocalClock(&clock);
+  *result = clock.date;
+  int32_t seconds = local % 86400;
+  result->tm_hour = seconds / 3600;
+  result->tm_min = seconds / 60 % 60;
+  result->tm_sec = seconds % 60;
+  return result;
+}
+
+/**
+ * Replaces getLocalTime() which waits up to 5s for the time to be set.
+ *
+ * @return false if the clock hasn't been set yet
+ */
+bool getLocalNow(struct tm *result) {
+  time_t now = time(nullptr);
+  if (now < LOCAL_CLOCK_MIN_VALID) return false;
+  updateLocalClock(now, result);
+  return true;
+}
+
+void setTimezone(const char* timezone) {
+  log_i("Setting timezone to '%s'.", timezone);
+  // Clock settings are adjusted to show the new local time
+  setenv("TZ", timezone, 1);
+  tzset();
+  // the cached offset belongs to the previous zone
+  portENTER_CRITICAL(&localClockMux);
+  localClock.validFrom = 0;
+  localClock.nextTransition = 0;
+  localClock.zone++;
+  portEXIT_CRITICAL(&localClockMux);
+}
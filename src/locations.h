@@ -0,0 +1,328 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <LittleFS.h>
+#include <atomic>
+
+#include "WeatherClient.h"
+#include "WeatherSnapshot.h"
+#include "config.h"
+#include "localclock.h"
+#include "refresh.h"
+#include "settings.h"
+
+// the snapshot of location i is persisted to /weather-i.bin
+#define LOCATION_SNAPSHOT_FILE "/weather-%d.bin"
+
+static_assert(NUMBER_OF_FORECASTS <= WEATHER_SNAPSHOT_FORECASTS,
+              "a WeatherSnapshot must hold NUMBER_OF_FORECASTS forecasts");
+
+typedef enum LocationUpdate {
+  LOCATION_UPDATE_FAILED,
+  // nothing was due or OpenWeatherMap had nothing new, neither saved nor worth a redraw
+  LOCATION_UNCHANGED,
+  LOCATION_UPDATED
+} LocationUpdate;
+
+/**
+ * When OpenWeatherMap is expected to have new data for one endpoint of a location. Requests
+ * before notBeforeMillis only cost radio time: the response is still fresh as per max-age or the
+ * data doesn't change that often going by the interval between the last changes.
+ */
+typedef struct RefreshState {
+  HttpCacheState cache;
+  // epoch seconds of the last change seen, 0 until there was one
+  uint32_t lastChange;
+  // smoothed interval between changes, 0 until two were seen
+  uint32_t cadenceSeconds;
+  unsigned long notBeforeMillis;
+} RefreshState;
+
+// one per configured location, switching between them is served from here
+WeatherSnapshot locationWeather[LOCATION_COUNT];
+// responses are parsed into this one, the cache only ever holds complete snapshots
+WeatherSnapshot scratchSnapshot;
+// odd while a snapshot of locationWeather is being written, see copyLocationWeather()
+std::atomic<uint32_t> locationWeatherSequence(0);
+uint8_t displayedLocation = 0;
+// the locations are updated in turn, one every getRefreshIntervalMillis() / LOCATION_COUNT
+uint8_t nextLocationUpdate = 0;
+unsigned long nextLocationUpdateMillis = 0;
+unsigned long locationSpacingMillis = 0;
+// due right away after a boot
+RefreshState currentRefresh[LOCATION_COUNT];
+RefreshState forecastRefresh[LOCATION_COUNT];
+
+void loadLocationSnapshot(uint8_t index);
+void onLocationConfigChange(uint32_t changed, const Config *previous);
+void saveLocationSnapshot(uint8_t index);
+
+/**
+ * Restores the weather persisted by the last update of each location, call after initFileSystem()
+ * and initConfig().
+ */
+void initLocations() {
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    loadLocationSnapshot(i);
+  }
+  log_i("Weather cache for %d locations: %d bytes.", LOCATION_COUNT, sizeof(locationWeather));
+  onConfigChange(CONFIG_API_KEY | CONFIG_LOCATIONS | CONFIG_UPDATE_INTERVAL,
+                 onLocationConfigChange);
+}
+
+// A copy, any task may ask while the loop commits another name.
+String getLocationName(uint8_t index) {
+  char name[sizeof(ConfigLocation::name)];
+  portENTER_CRITICAL(&configMux);
+  strlcpy(name, config.locations[index].name, sizeof(name));
+  portEXIT_CRITICAL(&configMux);
+  return String(name);
+}
+
+WeatherSnapshot *getDisplayedWeather() {
+  return &locationWeather[displayedLocation];
+}
+
+// Writes the snapshot of the location, only the tasks updating locations may.
+void storeLocationWeather(uint8_t index, const WeatherSnapshot *snapshot) {
+  uint32_t sequence = locationWeatherSequence.load(std::memory_order_relaxed);
+  locationWeatherSequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  locationWeather[index] = *snapshot;
+  locationWeatherSequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * Copies the snapshot of the location for a task that doesn't update locations, e.g. the display
+ * task. Lock-free (seqlock): the copy is retried if a write overlapped with it.
+ */
+void copyLocationWeather(uint8_t index, WeatherSnapshot *copy) {
+  while (true) {
+    uint32_t before = locationWeatherSequence.load(std::memory_order_acquire);
+    if (before % 2 == 0) {
+      memcpy(copy, &locationWeather[index], sizeof(WeatherSnapshot));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (locationWeatherSequence.load(std::memory_order_relaxed) == before) return;
+    }
+    delay(1);
+  }
+}
+
+// the weather of the first location also drives the backlight (sunrise/sunset)
+WeatherSnapshot *getHomeWeather() {
+  return &locationWeather[0];
+}
+
+void showNextLocation() {
+  displayedLocation = (displayedLocation + 1) % LOCATION_COUNT;
+  log_i("Showing %s.", getLocationName(displayedLocation).c_str());
+}
+
+bool isRefreshDue(const RefreshState *state) {
+  return (long)(millis() - state->notBeforeMillis) >= 0;
+}
+
+bool isLocationRefreshDue(uint8_t index) {
+  return isRefreshDue(&currentRefresh[index]) || isRefreshDue(&forecastRefresh[index]);
+}
+
+/**
+ * Learns the interval between changes and holds off the next request until max-age has passed
+ * and the next change is expected, but no longer than WEATHER_MAX_REFRESH_MINUTES. Once the
+ * expected change is overdue the endpoint is requested on every turn of the location again.
+ *
+ * @param changeTime epoch seconds the data changed at, ignored unless changed
+ */
+void scheduleRefresh(RefreshState *state, bool changed, uint32_t changeTime) {
+  time_t now = time(nullptr);
+  if (changed && now >= LOCAL_CLOCK_MIN_VALID) {
+    if (state->lastChange != 0 && changeTime > state->lastChange) {
+      uint32_t interval = changeTime - state->lastChange;
+      // shrinks at once, grows slowly: better an unneeded request than stale data
+      state->cadenceSeconds = state->cadenceSeconds == 0 || interval < state->cadenceSeconds
+                                  ? interval
+                                  : (3 * state->cadenceSeconds + interval) / 4;
+    }
+    state->lastChange = changeTime;
+  }
+
+  long waitSeconds = state->cache.maxAgeSeconds;
+  if (state->cadenceSeconds > 0 && now >= LOCAL_CLOCK_MIN_VALID) {
+    long untilChange = (long)(state->lastChange + state->cadenceSeconds - now);
+    if (untilChange > waitSeconds) waitSeconds = untilChange;
+  }
+  state->notBeforeMillis = millis() + min(waitSeconds, WEATHER_MAX_REFRESH_MINUTES * 60L) * 1000;
+}
+
+void copyForecasts(WeatherSnapshot *to, const WeatherSnapshot *from) {
+  to->forecastCount = from->forecastCount;
+  memcpy(to->forecasts, from->forecasts, from->forecastCount * sizeof(ForecastRecord));
+}
+
+bool isSameForecasts(const WeatherSnapshot *a, const WeatherSnapshot *b) {
+  return a->forecastCount == b->forecastCount &&
+         memcmp(a->forecasts, b->forecasts, a->forecastCount * sizeof(ForecastRecord)) == 0;
+}
+
+/**
+ * Fetches current weather and forecasts of the location, as far as they are due. Requests are
+ * conditional (ETag/Last-Modified) and the current weather isn't parsed beyond its observation
+ * time if that's the one there is already.
+ *
+ * @return LOCATION_UPDATE_FAILED if either request failed, the location keeps its previous weather
+ *         then
+ */
+LocationUpdate updateLocation(uint8_t index) {
+  // the boot task gets here as well
+  Config settings;
+  readConfig(&settings);
+  const char *id = settings.locations[index].id;
+  const char *name = settings.locations[index].name;
+  const WeatherSnapshot *cached = &locationWeather[index];
+  RefreshState *current = &currentRefresh[index];
+  RefreshState *forecast = &forecastRefresh[index];
+  bool currentDue = isRefreshDue(current);
+  bool forecastDue = isRefreshDue(forecast);
+  clearSnapshot(&scratchSnapshot);
+
+  WeatherClient client;
+  client.setLanguage(OPEN_WEATHER_MAP_LANGUAGE);
+  client.setAllowedHours(forecastHoursUtc, sizeof(forecastHoursUtc));
+  // parts that weren't requested or didn't change are taken over from the cache
+  FetchResult currentResult = FETCH_NOT_MODIFIED;
+  if (currentDue) {
+    currentResult = client.updateCurrent(&scratchSnapshot, settings.apiKey, id,
+                                         &current->cache, cached->current.observationTime);
+  }
+  if (currentResult == FETCH_NOT_MODIFIED) {
+    // parsing may have stopped half-way
+    clearSnapshot(&scratchSnapshot);
+    scratchSnapshot.current = cached->current;
+  }
+  FetchResult forecastResult = FETCH_NOT_MODIFIED;
+  if (forecastDue && currentResult != FETCH_FAILED) {
+    forecastResult = client.updateForecasts(&scratchSnapshot, settings.apiKey, id,
+                                            &forecast->cache);
+  }
+  countApiCalls(currentDue + (forecastDue && currentResult != FETCH_FAILED));
+  if (currentResult == FETCH_FAILED || forecastResult == FETCH_FAILED) {
+    log_e("Failed to update the weather in %s.", name);
+    // the validators may belong to a response that was just discarded
+    memset(&current->cache, 0, sizeof(HttpCacheState));
+    memset(&forecast->cache, 0, sizeof(HttpCacheState));
+    return LOCATION_UPDATE_FAILED;
+  }
+  if (forecastResult == FETCH_NOT_MODIFIED) copyForecasts(&scratchSnapshot, cached);
+
+  bool currentChanged = currentResult == FETCH_UPDATED;
+  bool forecastChanged =
+      forecastResult == FETCH_UPDATED && !isSameForecasts(&scratchSnapshot, cached);
+  if (currentDue) scheduleRefresh(current, currentChanged, scratchSnapshot.current.observationTime);
+  if (forecastDue) scheduleRefresh(forecast, forecastChanged, time(nullptr));
+  if (currentChanged) {
+    recordObservation(index, name, &cached->current, &scratchSnapshot.current);
+  }
+  if (!currentChanged && !forecastChanged) {
+    log_i("No new weather in %s.", name);
+    return LOCATION_UNCHANGED;
+  }
+
+  storeLocationWeather(index, &scratchSnapshot);
+  saveLocationSnapshot(index);
+  const CurrentRecord &currentWeather = scratchSnapshot.current;
+  log_i("Current weather in %s: %s, %.1f°, %d forecasts", name,
+        currentWeather.description,
+        fromHundredths(currentWeather.feelsLike), scratchSnapshot.forecastCount);
+  return LOCATION_UPDATED;
+}
+
+void loadLocationSnapshot(uint8_t index) {
+  WeatherSnapshot *snapshot = &locationWeather[index];
+  clearSnapshot(snapshot);
+  char path[20];
+  snprintf(path, sizeof(path), LOCATION_SNAPSHOT_FILE, index);
+  if (!LittleFS.exists(path)) return;
+
+  File file = LittleFS.open(path, "r");
+  if (file.size() != sizeof(WeatherSnapshot) ||
+      file.read((uint8_t *)snapshot, sizeof(WeatherSnapshot)) != sizeof(WeatherSnapshot) ||
+      !isSnapshotValid(snapshot)) {
+    log_w("Discarding weather snapshot %s.", path);
+    clearSnapshot(snapshot);
+  }
+  file.close();
+}
+
+void saveLocationSnapshot(uint8_t index) {
+  char path[20];
+  snprintf(path, sizeof(path), LOCATION_SNAPSHOT_FILE, index);
+  File file = LittleFS.open(path, "w");
+  if (!file ||
+      file.write((uint8_t *)&locationWeather[index], sizeof(WeatherSnapshot)) !=
+          sizeof(WeatherSnapshot)) {
+    log_e("Failed to persist weather snapshot %s.", path);
+  }
+  file.close();
+}
+
+bool isLocationUpdateDue() {
+  return (long)(millis() - nextLocationUpdateMillis) >= 0;
+}
+
+/**
+ * Schedules the update of the next location in turn, evenly spaced so that every location is
+ * updated once per getRefreshIntervalMillis() without bursts of requests.
+ *
+ * @param restart start over with the first location, after all of them were just updated
+ */
+void scheduleNextLocationUpdate(bool restart) {
+  locationSpacingMillis = getRefreshIntervalMillis() / LOCATION_COUNT;
+  if (restart) {
+    nextLocationUpdate = 0;
+    nextLocationUpdateMillis = millis() + locationSpacingMillis;
+    return;
+  }
+  nextLocationUpdate = (nextLocationUpdate + 1) % LOCATION_COUNT;
+  nextLocationUpdateMillis += locationSpacingMillis;
+  // fell behind, e.g. on a slow network: keep the spacing rather than catching up at once
+  if (isLocationUpdateDue()) nextLocationUpdateMillis = millis() + locationSpacingMillis;
+}
+
+// Brings the pending update forward if the interval got shorter, e.g. someone looks again.
+void rescheduleLocationUpdate() {
+  unsigned long spacingMillis = getRefreshIntervalMillis() / LOCATION_COUNT;
+  if (spacingMillis >= locationSpacingMillis) return;
+  nextLocationUpdateMillis = nextLocationUpdateMillis - locationSpacingMillis + spacingMillis;
+  locationSpacingMillis = spacingMillis;
+}
+
+/**
+ * Validators and cadences belong to the previous API key or location ID, they start over. A
+ * location with another ID also drops its weather. Either way the locations are due right away,
+ * in turn. A new name only needs a redraw, see main.cpp.
+ */
+void onLocationConfigChange(uint32_t changed, const Config *previous) {
+  if (changed & CONFIG_UPDATE_INTERVAL) rescheduleLocationUpdate();
+  if ((changed & (CONFIG_API_KEY | CONFIG_LOCATIONS)) == 0) return;
+
+  bool due = false;
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    bool moved = strcmp(previous->locations[i].id, config.locations[i].id) != 0;
+    if (!moved && (changed & CONFIG_API_KEY) == 0) continue;
+    memset(&currentRefresh[i], 0, sizeof(RefreshState));
+    memset(&forecastRefresh[i], 0, sizeof(RefreshState));
+    if (moved) {
+      log_i("Location %d is now %s (%s).", i, config.locations[i].name, config.locations[i].id);
+      clearSnapshot(&scratchSnapshot);
+      storeLocationWeather(i, &scratchSnapshot);
+      saveLocationSnapshot(i);
+      memset(&weatherTrends[i], 0, sizeof(WeatherTrend));
+    }
+    due = true;
+  }
+  if (!due) return;
+  nextLocationUpdate = 0;
+  nextLocationUpdateMillis = millis();
+}
@@ -7,17 +7,30 @@
 #include <TJpg_Decoder.h>
 
 #include "fonts/open-sans.h"
+#include "AssetStore.h"
+#include "AsyncBlitter.h"
+#include "ForecastChart.h"
 #include "GfxUi.h"
+#include "ProgressBar.h"
+#include "RenderQueue.h"
+#include "ShadowFrame.h"
 
-#include <JsonListener.h>
-#include <OpenWeatherMapCurrent.h>
-#include <OpenWeatherMapForecast.h>
 #include <SunMoonCalc.h>
 
+#include "astro.h"
+#include "backlight.h"
+#include "benchmark.h"
+#include "config.h"
 #include "connectivity.h"
 #include "display.h"
+#include "icons.h"
+#include "layout.h"
+#include "locations.h"
 #include "persistence.h"
+#include "power.h"
 #include "settings.h"
+#include "spiclock.h"
+#include "timesync.h"
 #include "util.h"
 
 
@@ -28,18 +41,30 @@
 OpenFontRender ofr;
 FT6236 ts = FT6236(TFT_HEIGHT, TFT_WIDTH);
 TFT_eSPI tft = TFT_eSPI();
-TFT_eSprite timeSprite = TFT_eSprite(&tft);
-GfxUi ui = GfxUi(&tft, &ofr);
+// everything is drawn to the shadow frame and flushed to the display from there
+ShadowFrame frame = ShadowFrame(&tft);
+AssetStore assets;
+AsyncBlitter blitter = AsyncBlitter(&tft);
+GfxUi ui = GfxUi(&tft, &ofr, &assets);
+ForecastChart forecastChart = ForecastChart(&tft, &ofr);
+// other tasks only queue drawing, the display task draws to the shadow frame and flushes it
+RenderQueue renderQueue = RenderQueue(&frame, &ofr);
+ProgressBar progressBar = ProgressBar(&renderQueue);
+// the displayed location as of the last drawWeather(), owned by the display task
+WeatherSnapshot paintedWeather;
+uint8_t paintedLocation = 0;
+// units and names as of the last drawWeather(), config may be replaced on the loop meanwhile
+Config paintedConfig;
 
 // time management variables
-int updateIntervalMillis = UPDATE_INTERVAL_MINUTES * 60 * 1000;
-unsigned long lastTimeSyncMillis = 0;
 unsigned long lastUpdateMillis = 0;
+// the boot task reports its latest step here, the bar catches up with skipped ones anyway
+QueueHandle_t bootProgress = nullptr;
+volatile bool bootStepsDone = false;
 
-const int16_t centerWidth = tft.width() / 2;
-
-OpenWeatherMapCurrentData currentWeather;
-OpenWeatherMapForecastData forecasts[NUMBER_OF_FORECASTS];
+// tapping the forecast section toggles between the daily forecasts and the 3h chart
+bool showForecastChart = false;
+bool wasTouched = false;
 
 
 
@@ -47,17 +72,30 @@ OpenWeatherMapForecastData forecasts[NUMBER_OF_FORECASTS];
 // Function prototypes (declarations)
 // ----------------------------------------------------------------------------
 void drawAstro();
+void drawBootScreen();
 void drawCurrentWeather();
+void drawDashboard();
 void drawForecast();
-void drawProgress(const char *text, int8_t percentage);
+void drawForecastChart();
+void drawProgressText(const char *text);
+void drawSeparator(const HorizontalLine &line);
+void drawText(const char *text, const RectangleDef &region, const Slot &slot);
 void drawTimeAndDate();
-String getWeatherIconName(uint16_t id, bool today);
+void drawWeather();
+void redrawForecast();
+void render(void (*painter)());
+void flushFrame(const RectangleDef *area);
+void handleTouch();
+void onDisplayConfigChange(uint32_t changed, const Config *previous);
 void initJpegDecoder();
 void initOpenFontRender();
 bool pushImageToTft(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap);
-void syncTime();
 void repaint();
+void reportProgress(const char *text, uint8_t percentage);
+void runBootSteps();
+void bootTask(void *parameter);
 void updateData(boolean updateProgressBar);
+void updateNextLocation();
 
 
 
@@ -74,36 +112,93 @@ void setup(void) {
   initJpegDecoder();
   initTouchScreen(&ts);
   initTft(&tft);
-  timeSprite.createSprite(timeSpritePos.width, timeSpritePos.height);
+  initBacklightControl();
+  initPowerManagement();
+  if (!frame.begin()) {
+    log_w("Drawing straight to the display, expect flicker.");
+  }
   logDisplayDebugInfo(&tft);
 
   initFileSystem();
+  initConfig();
+  initLocations();
+  initAstro();
+#ifdef ASSETS_PARTITION
+  assets.beginPartition(ASSET_PARTITION);
+#else
+  assets.begin(LittleFS, ASSET_ARCHIVE);
+#endif
+  initSpiClock(&tft);
   initOpenFontRender();
+  initTimeSync();
+  setTimezone(config.timezone);
+  forecastChart.setMetric(config.isMetric);
+  forecastChart.setLocalTime(toLocalTime);
+  onConfigChange(CONFIG_WIFI, onWiFiConfigChange);
+  onConfigChange(CONFIG_LOCATIONS | CONFIG_UNITS | CONFIG_TIMEZONE, onDisplayConfigChange);
+  blitter.setWriteFrequency(spiWriteFrequency);
+  frame.setWriteFrequency(spiWriteFrequency);
+  if (blitter.begin(BLIT_TASK_CORE)) {
+    ui.setBlitter(&blitter);
+    frame.setBlitter(&blitter);
+  }
+
+#ifdef BENCHMARK
+  // before the canvas is set so the drawing benchmarks go to the display
+  runBenchmarks(&tft, &ui, &blitter, &frame);
+#endif
+  ui.setCanvas(frame.canvas());
+  forecastChart.setCanvas(frame.canvas());
+
+#ifdef BENCHMARK
+  loadBenchmarkDataset(&paintedWeather);
+  readConfig(&paintedConfig);
+  const BenchmarkWidget widgets[] = {
+    {"clock", drawTimeAndDate, &LAYOUT.time.region},
+    {"currentWeather", drawCurrentWeather, &LAYOUT.current.region},
+    {"forecast", drawForecast, &LAYOUT.forecast.region},
+    {"forecastChart", drawForecastChart, &LAYOUT.forecast.region},
+    {"astro", drawAstro, &LAYOUT.astro.region},
+  };
+  benchmarkFrames(&frame, &assets, widgets, sizeof(widgets) / sizeof(widgets[0]));
+#endif
+  // from here on only the display task draws, or the tasks posting if it can't be started
+  if (!renderQueue.begin(xPortGetCoreID())) {
+    log_w("No display task, the loop waits for drawing.");
+  }
 }
 
 void loop(void) {
-  // update if
-  // - never (successfully) updated before OR
-  // - last sync too far back
-  if (lastTimeSyncMillis == 0 ||
-      lastUpdateMillis == 0 ||
-      (millis() - lastUpdateMillis) > updateIntervalMillis) {
+  // repaint with progress if
+  // - time never synchronized OR
+  // - never (successfully) updated before
+  // otherwise the locations are updated one by one in the background
+  if (!isTimeSynced() || lastUpdateMillis == 0) {
     repaint();
-  } else {
-    drawTimeAndDate();
+  } else if (isLocationUpdateDue()) {
+    updateNextLocation();
+  } else if (isBacklightOn()) {
+    render(drawTimeAndDate);
+  }
+  if (lastUpdateMillis > 0) {
+    time_t now = time(nullptr);
+    const CurrentRecord &home = getHomeWeather()->current;
+    AstroDay today;
+    updateBacklight(now, getAstroDay(now, home.lat, home.lon, &today) ? &today : nullptr);
   }
-  delay(1000);
-
-  // if (ts.touched()) {
-  //   TS_Point p = ts.getPoint();
-
-  //   uint16_t touchX = p.x;
-  //   uint16_t touchY = p.y;
 
-  //   log_d("Touch coordinates: x=%d, y=%d", touchX, touchY);
-  //   // Debouncing; avoid returning the same touch multiple times.
-  //   delay(50);
-  // }
+  // wait for the next clock tick, handle touches in the meantime
+  while (!takeClockTick()) {
+#ifdef POWER_SAVING
+    // SPI must be idle
+    renderQueue.wait();
+    sleepUntilNextEvent(nextLocationUpdateMillis);
+#else
+    delay(50);
+#endif
+    handleTouch();
+    handleConfigCommands();
+  }
 }
 
 
@@ -112,175 +207,287 @@ void loop(void) {
 // Functions
 // ----------------------------------------------------------------------------
 void drawAstro() {
+  const AstroLayout &astro = LAYOUT.astro;
+  const CurrentRecord &currentWeather = paintedWeather.current;
   time_t tnow = time(nullptr);
-  struct tm *nowUtc = gmtime(&tnow);
-
-  SunMoonCalc smCalc = SunMoonCalc(mkgmtime(nowUtc), currentWeather.lat, currentWeather.lon);
-  const SunMoonCalc::Result result = smCalc.calculateSunAndMoonData();
+  struct tm local;
+  char timestamp[TIMESTAMP_LENGTH];
+  AstroDay day;
+  const AstroDay *astroDay = &day;
 
-  ofr.setFontSize(24);
-  ofr.cdrawString(SUN_MOON_LABEL[0].c_str(), 60, 365);
-  ofr.cdrawString(SUN_MOON_LABEL[1].c_str(), tft.width() - 60, 365);
+  drawText(SUN_MOON_LABEL[0].c_str(), astro.region, astro.sunLabel);
+  drawText(SUN_MOON_LABEL[1].c_str(), astro.region, astro.moonLabel);
+  // only the labels until the clock is set
+  if (!getAstroDay(tnow, currentWeather.lat, currentWeather.lon, &day)) return;
 
-  ofr.setFontSize(18);
   // Sun
-  strftime(timestampBuffer, 26, UI_TIME_FORMAT_NO_SECONDS, localtime(&result.sun.rise));
-  ofr.cdrawString(timestampBuffer, 60, 400);
-  strftime(timestampBuffer, 26, UI_TIME_FORMAT_NO_SECONDS, localtime(&result.sun.set));
-  ofr.cdrawString(timestampBuffer, 60, 425);
+  strftime(timestamp, sizeof(timestamp), UI_TIME_FORMAT_NO_SECONDS,
+           toLocalTime(astroDay->sunRise, &local));
+  drawText(timestamp, astro.region, astro.sunRise);
+  strftime(timestamp, sizeof(timestamp), UI_TIME_FORMAT_NO_SECONDS,
+           toLocalTime(astroDay->sunSet, &local));
+  drawText(timestamp, astro.region, astro.sunSet);
 
   // Moon
-  strftime(timestampBuffer, 26, UI_TIME_FORMAT_NO_SECONDS, localtime(&result.moon.rise));
-  ofr.cdrawString(timestampBuffer, tft.width() - 60, 400);
-  strftime(timestampBuffer, 26, UI_TIME_FORMAT_NO_SECONDS, localtime(&result.moon.set));
-  ofr.cdrawString(timestampBuffer, tft.width() - 60, 425);
+  strftime(timestamp, sizeof(timestamp), UI_TIME_FORMAT_NO_SECONDS,
+           toLocalTime(astroDay->moonRise, &local));
+  drawText(timestamp, astro.region, astro.moonRise);
+  strftime(timestamp, sizeof(timestamp), UI_TIME_FORMAT_NO_SECONDS,
+           toLocalTime(astroDay->moonSet, &local));
+  drawText(timestamp, astro.region, astro.moonSet);
 
   // Moon icon
-  int imageIndex = round(result.moon.age * NUMBER_OF_MOON_IMAGES / LUNAR_MONTH);
+  float moonAge = getMoonAge(astroDay, tnow);
+  int imageIndex = round(moonAge * NUMBER_OF_MOON_IMAGES / LUNAR_MONTH);
   if (imageIndex == NUMBER_OF_MOON_IMAGES) imageIndex = NUMBER_OF_MOON_IMAGES - 1;
-  ui.drawBmp("/moon/m-phase-" + String(imageIndex) + ".bmp", centerWidth - 37, 365);
+  LayoutPoint moonIcon = place(astro.region, astro.moonIcon);
+  ui.drawBmp("/moon/m-phase-" + String(imageIndex) + ".bmp", moonIcon.x, moonIcon.y);
 
-  ofr.setFontSize(14);
-  ofr.cdrawString(MOON_PHASES[result.moon.phase.index].c_str(), centerWidth, 455);
+  drawText(MOON_PHASES[astroDay->moonPhaseIndex].c_str(), astro.region, astro.moonPhase);
 
   log_i("Moon phase: %s, illumination: %f, age: %f -> image index: %d",
-        result.moon.phase.name.c_str(), result.moon.illumination, result.moon.age, imageIndex);
+        MOON_PHASES[astroDay->moonPhaseIndex].c_str(), astroDay->moonIllumination, moonAge,
+        imageIndex);
 }
 
 void drawCurrentWeather() {
+  const CurrentWeatherLayout &current = LAYOUT.current;
+  const WeatherSnapshot *weather = &paintedWeather;
+  const CurrentRecord &currentWeather = weather->current;
   // re-use variable throughout function
   String text = "";
 
-  // icon
-  String weatherIcon = getWeatherIconName(currentWeather.weatherId, true);
-  ui.drawBmp("/weather/" + weatherIcon + ".bmp", 5, 125);
-  // tft.drawRect(5, 125, 100, 100, 0x4228);
+  // icon, night versions only for the current weather as forecasts don't track sunrise/sunset
+  bool night = currentWeather.observationTime < currentWeather.sunrise ||
+               currentWeather.observationTime > currentWeather.sunset;
+  WeatherIcon icon = weatherIcon(conditionCode(currentWeather.condition), night);
+  LayoutPoint iconPos = place(current.region, current.icon);
+  ui.drawBmp(WEATHER_ICON_ASSETS[icon].large, iconPos.x, iconPos.y);
 
   // condition string
-  ofr.setFontSize(24);
-  ofr.cdrawString(currentWeather.description.c_str(), centerWidth, 95);
-
-  // temperature incl. symbol, slightly shifted to the right to find better balance due to the ° symbol
-  ofr.setFontSize(48);
-  text = String(currentWeather.temp, 1) + "°";
-  ofr.cdrawString(text.c_str(), centerWidth + 10, 120);
+  drawText(currentWeather.description, current.region, current.description);
 
-  ofr.setFontSize(18);
+  // temperature incl. symbol
+  text = String(displayTemperature(fromHundredths(currentWeather.temp), paintedConfig.isMetric),
+                1) + "°";
+  drawText(text.c_str(), current.region, current.temperature);
 
   // humidity
   text = String(currentWeather.humidity) + " %";
-  ofr.cdrawString(text.c_str(), centerWidth, 178);
+  drawText(text.c_str(), current.region, current.humidity);
 
   // pressure
   text = String(currentWeather.pressure) + " hPa";
-  ofr.cdrawString(text.c_str(), centerWidth, 200);
+  drawText(text.c_str(), current.region, current.pressure);
 
   // wind rose icon
-  int windAngleIndex = round(currentWeather.windDeg * 8 / 360);
+  int windAngleIndex = round(currentWeather.windDeg * 8 / 360.0);
   if (windAngleIndex > 7) windAngleIndex = 0;
-  ui.drawBmp("/wind/" + WIND_ICON_NAMES[windAngleIndex] + ".bmp", tft.width() - 80, 125);
-  // tft.drawRect(tft.width() - 80, 125, 75, 75, 0x4228);
+  LayoutPoint windIcon = place(current.region, current.windIcon);
+  ui.drawBmp("/wind/" + WIND_ICON_NAMES[windAngleIndex] + ".bmp", windIcon.x, windIcon.y);
 
   // wind speed
-  text = String(currentWeather.windSpeed, 0);
-  if (IS_METRIC) text += " m/s";
+  text = String(displaySpeed(fromHundredths(currentWeather.windSpeed), paintedConfig.isMetric), 0);
+  if (paintedConfig.isMetric) text += " m/s";
   else text += " mph";
-  ofr.cdrawString(text.c_str(), tft.width() - 43, 200);
+  drawText(text.c_str(), current.region, current.windSpeed);
+
+  if (LOCATION_COUNT > 1) {
+    drawText(paintedConfig.locations[paintedLocation].name, current.region, current.location);
+  }
 }
 
 void drawForecast() {
-  DayForecast* dayForecasts = calculateDayForecasts(forecasts);
+  if (showForecastChart) {
+    drawForecastChart();
+    return;
+  }
+
+  DayForecast* dayForecasts = calculateDayForecasts(&paintedWeather);
   for (int i = 0; i < NUMBER_OF_DAY_FORECASTS; i++) {
     log_i("[%d] condition code: %d, hour: %d, temp: %.1f/%.1f", dayForecasts[i].day,
           dayForecasts[i].conditionCode, dayForecasts[i].conditionHour, dayForecasts[i].minTemp,
           dayForecasts[i].maxTemp);
   }
 
-  int widthEigth = tft.width() / 8;
+  const ForecastLayout &forecast = LAYOUT.forecast;
   for (int i = 0; i < NUMBER_OF_DAY_FORECASTS; i++) {
-    int x = widthEigth * ((i * 2) + 1);
-    ofr.setFontSize(24);
-    ofr.cdrawString(WEEKDAYS_ABBR[dayForecasts[i].day].c_str(), x, 235);
-    ofr.setFontSize(18);
-    ofr.cdrawString(String(String(dayForecasts[i].minTemp, 0) + "-" + String(dayForecasts[i].maxTemp, 0) + "°").c_str(), x, 265);
-    ui.drawBmp("/weather-small/" + getWeatherIconName(dayForecasts[i].conditionCode, false) + ".bmp", x - 25, 295);
+    RectangleDef column = forecastColumn(forecast.region, i, NUMBER_OF_DAY_FORECASTS);
+    drawText(WEEKDAYS_ABBR[dayForecasts[i].day].c_str(), column, forecast.weekday);
+    float minTemp = displayTemperature(dayForecasts[i].minTemp, paintedConfig.isMetric);
+    float maxTemp = displayTemperature(dayForecasts[i].maxTemp, paintedConfig.isMetric);
+    drawText(String(String(minTemp, 0) + "-" + String(maxTemp, 0) + "°").c_str(), column,
+             forecast.temperatures);
+    WeatherIcon icon = weatherIcon(dayForecasts[i].conditionCode, false);
+    LayoutPoint iconPos = place(column, forecast.icon);
+    ui.drawBmp(WEATHER_ICON_ASSETS[icon].small, iconPos.x, iconPos.y);
   }
 }
 
-void drawProgress(const char *text, int8_t percentage) {
-  ofr.setFontSize(24);
-  int pbWidth = tft.width() - 100;
-  int pbX = (tft.width() - pbWidth)/2;
-  int pbY = 260;
-  int progressTextY = 210;
+void drawForecastChart() {
+  const RectangleDef &region = LAYOUT.forecast.region;
+  const WeatherSnapshot *weather = &paintedWeather;
+  forecastChart.draw(weather->forecasts, weather->forecastCount, WEEKDAYS_ABBR, region.x, region.y,
+                     region.width, region.height);
+}
+
+// Replaces the boot step above the progress bar, only its band is cleared and flushed.
+void drawProgressText(const char *text) {
+  LayoutPoint textPos = place(LAYOUT.screen, LAYOUT.progress.text);
+  renderQueue.fill(0, textPos.y, LAYOUT.screen.width, PROGRESS_TEXT_HEIGHT, TFT_BLACK);
+  renderQueue.text(text, textPos.x, textPos.y, LAYOUT.progress.text.fontSize);
+  renderQueue.flush(0, textPos.y, LAYOUT.screen.width, PROGRESS_TEXT_HEIGHT);
+}
 
-  tft.fillRect(0, progressTextY, tft.width(), 40, TFT_BLACK);
-  ofr.cdrawString(text, centerWidth, progressTextY);
-  ui.drawProgressBar(pbX, pbY, pbWidth, 15, percentage, TFT_WHITE, TFT_TP_BLUE);
+void drawSeparator(const HorizontalLine &line) {
+  frame.surface()->drawFastHLine(line.x, line.y, line.width, 0x4228);
 }
 
-void drawSeparator(uint16_t y) {
-  tft.drawFastHLine(10, y, tft.width() - 2 * 15, 0x4228);
+// Draws the text centered on the slot.
+void drawText(const char *text, const RectangleDef &region, const Slot &slot) {
+  LayoutPoint pos = place(region, slot);
+  BENCHMARK_COUNT_GLYPHS(text);
+  ofr.setFontSize(slot.fontSize);
+  ofr.cdrawString(text, pos.x, pos.y);
 }
 
 void drawTimeAndDate() {
-  timeSprite.fillSprite(TFT_BLACK);
-  ofr.setDrawer(timeSprite);
+  const TimeLayout &layout = LAYOUT.time;
+  frame.surface()->fillRect(layout.region.x, layout.region.y, layout.region.width,
+                           layout.region.height, TFT_BLACK);
 
   // Date
-  ofr.setFontSize(16);
-  ofr.cdrawString(
+  drawText(
     String(WEEKDAYS[getCurrentWeekday()] + ", " + getCurrentTimestamp(UI_DATE_FORMAT)).c_str(),
-    centerWidth,
-    10
+    layout.region,
+    layout.date
   );
 
   // Time
-  ofr.setFontSize(48);
   // centering that string would look optically odd for 12h times -> manage pos manually
-  ofr.drawString(getCurrentTimestamp(UI_TIME_FORMAT).c_str(), timePosX, 25);
-  timeSprite.pushSprite(timeSpritePos.x, timeSpritePos.y);
+  LayoutPoint timePos = place(layout.region, layout.time);
+  String timeText = getCurrentTimestamp(UI_TIME_FORMAT);
+  BENCHMARK_COUNT_GLYPHS(timeText.c_str());
+  ofr.setFontSize(layout.time.fontSize);
+  ofr.drawString(timeText.c_str(), timePos.x - UI_TIME_WIDTH * layout.time.fontSize / 48 / 2,
+                 timePos.y);
+  // usually only the seconds changed, that's a few tiles
+  flushFrame(&layout.region);
+}
+
+// Current weather, forecast and sun & moon of the displayed location, with its latest weather.
+void drawWeather() {
+  paintedLocation = displayedLocation;
+  copyLocationWeather(paintedLocation, &paintedWeather);
+  readConfig(&paintedConfig);
+  forecastChart.setMetric(paintedConfig.isMetric);
+  const RectangleDef *regions[] = {&LAYOUT.current.region, &LAYOUT.forecast.region,
+                                   &LAYOUT.astro.region};
+  for (const RectangleDef *region : regions) {
+    frame.surface()->fillRect(region->x, region->y, region->width, region->height, TFT_BLACK);
+  }
+  drawCurrentWeather();
+  drawForecast();
+  drawAstro();
+  for (const RectangleDef *region : regions) {
+    flushFrame(region);
+  }
+}
 
-  // set the drawer back since we temporarily changed it to the time sprite above
-  ofr.setDrawer(tft);
+// Switches between the daily forecasts and the chart.
+void redrawForecast() {
+  const RectangleDef &region = LAYOUT.forecast.region;
+  frame.surface()->fillRect(region.x, region.y, region.width, region.height, TFT_BLACK);
+  drawForecast();
+  flushFrame(&region);
 }
 
-String getWeatherIconName(uint16_t id, bool today) {
-  // Weather condition codes: https://openweathermap.org/weather-conditions#Weather-Condition-Codes-2
-
-  // For the 8xx group we also have night versions of the icons.
-  // Switch to night icons? This could be written w/o if-else but it'd be less legible.
-  if ( today && id/100 == 8) {
-    if (today && (currentWeather.observationTime < currentWeather.sunrise ||
-                  currentWeather.observationTime > currentWeather.sunset)) {
-      id += 1000;
-    } else if(!today && false) {
-      // NOT-SUPPORTED-YET
-      // We currently don't need the night icons for forecast.
-      // Hence, we don't even track those properties in the DayForecast struct.
-      // forecast->dt[0] < forecast->sunrise || forecast->dt[0] > forecast->sunset
-      id += 1000;
-    }
+// Logo and version above the progress bar.
+void drawBootScreen() {
+  frame.surface()->fillScreen(TFT_BLACK);
+  ui.drawLogo();
+  drawText(APP_NAME, LAYOUT.screen, LAYOUT.progress.appName);
+  drawText(VERSION, LAYOUT.screen, LAYOUT.progress.version);
+  flushFrame(nullptr);
+}
+
+// Everything after the boot screen.
+void drawDashboard() {
+  frame.surface()->fillScreen(TFT_BLACK);
+  drawTimeAndDate();
+  drawWeather();
+  for (uint8_t i = 0; i < LAYOUT_SEPARATORS; i++) {
+    if (LAYOUT.separators[i].width > 0) drawSeparator(LAYOUT.separators[i]);
+  }
+  flushFrame(nullptr);
+}
+
+/**
+ * Pushes what changed in the shadow frame within the area (all of it for nullptr) to the display,
+ * once the display task finished the batch of commands it's drawing. Only for painters.
+ */
+void flushFrame(const RectangleDef *area) {
+  if (area == nullptr) {
+    renderQueue.invalidate(0, 0, tft.width(), tft.height());
+  } else {
+    renderQueue.invalidate(area->x, area->y, area->width, area->height);
+  }
+}
+
+// Queues a painter (drawXyz()) for the display task, it runs after everything queued before.
+void render(void (*painter)()) {
+  renderQueue.paint([](void *context) { ((void (*)())context)(); }, (void *)painter);
+}
+
+void handleTouch() {
+  // only react to the moment the finger touches down, not while it rests on the screen
+  bool touched = ts.touched();
+  if (!touched || wasTouched) {
+    wasTouched = touched;
+    return;
+  }
+  wasTouched = true;
+  bool wasOff = registerActivity();
+  // someone's looking, the weather may be due sooner than scheduled while the display was dimmed
+  rescheduleLocationUpdate();
+  // the first touch only wakes up a dark display
+  if (wasOff) {
+    render(drawTimeAndDate);
+    return;
+  }
+
+  TS_Point p = ts.getPoint();
+  log_d("Touch coordinates: x=%d, y=%d", p.x, p.y);
+  // nothing to toggle before the first data update
+  if (lastUpdateMillis == 0) return;
+
+  const RectangleDef &forecastRegion = LAYOUT.forecast.region;
+  const RectangleDef &currentRegion = LAYOUT.current.region;
+  if (p.x >= forecastRegion.x && p.x < forecastRegion.x + forecastRegion.width &&
+      p.y >= forecastRegion.y && p.y < forecastRegion.y + forecastRegion.height) {
+    showForecastChart = !showForecastChart;
+    render(redrawForecast);
+  } else if (LOCATION_COUNT > 1 &&
+             p.x >= currentRegion.x && p.x < currentRegion.x + currentRegion.width &&
+             p.y >= currentRegion.y && p.y < currentRegion.y + currentRegion.height) {
+    // all from the cache, no request
+    showNextLocation();
+    render(drawWeather);
   }
+}
 
-  if (id/100 == 2) return "thunderstorm";
-  if (id/100 == 3) return "drizzle";
-  if (id == 500) return "light-rain";
-  if (id == 504) return "extrem-rain";
-  else if (id == 511) return "sleet";
-  else if (id/100 == 5) return "rain";
-  if (id >= 611 && id <= 616) return "sleet";
-  else if (id/100 == 6) return "snow";
-  if (id/100 == 7) return "fog";
-  if (id == 800) return "clear-day";
-  if (id >= 801 && id <= 803) return "partly-cloudy-day";
-  else if (id/100 == 8) return "cloudy";
-  // night icons
-  if (id == 1800) return "clear-night";
-  if (id == 1801) return "partly-cloudy-night";
-  else if (id/100 == 18) return "cloudy";
-
-  return "unknown";
+/**
+ * Units, names and the timezone only change what's drawn: the cached weather is redrawn without a
+ * request. Local days move with the timezone, so does everything that depends on them.
+ */
+void onDisplayConfigChange(uint32_t changed, const Config *previous) {
+  if (changed & CONFIG_TIMEZONE) {
+    setTimezone(config.timezone);
+    resetAstroTables();
+  }
+  // the boot screen is still up otherwise, the dashboard is drawn with the new settings anyway
+  if (lastUpdateMillis == 0) return;
+  render((changed & CONFIG_TIMEZONE) ? drawDashboard : drawWeather);
 }
 
 void initJpegDecoder() {
@@ -292,7 +499,7 @@ void initJpegDecoder() {
 
 void initOpenFontRender() {
   ofr.loadFont(opensans, sizeof(opensans));
-  ofr.setDrawer(tft);
+  ofr.setDrawer(*frame.surface());
   ofr.setFontColor(TFT_WHITE);
   ofr.setBackgroundColor(TFT_BLACK);
 }
@@ -305,72 +512,127 @@ bool pushImageToTft(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitm
     return 0;
   }
 
-  // Automatically clips the image block rendering at the TFT boundaries.
-  tft.pushImage(x, y, w, h, bitmap);
+  // Automatically clips the image block rendering at the TFT boundaries. Overlaps with decoding the
+  // next block.
+  ui.pushBlock(x, y, w, h, bitmap);
 
   // Return 1 to decode next block
   return 1;
 }
 
-void syncTime() {
-  if (initTime()) {
-    lastTimeSyncMillis = millis();
-    setTimezone(TIMEZONE);
-    log_i("Current local time: %s", getCurrentTimestamp(SYSTEM_TIMESTAMP_FORMAT).c_str());
+void repaint() {
+  render(drawBootScreen);
+  const RectangleDef &bar = LAYOUT.progress.bar;
+  progressBar.begin(bar.x, bar.y, bar.width, bar.height, TFT_WHITE, TFT_TP_BLUE);
+
+  // the steps block on the network, the screen keeps animating meanwhile
+  if (bootProgress == nullptr) bootProgress = xQueueCreate(1, sizeof(BootProgress));
+  bootStepsDone = false;
+  if (xTaskCreatePinnedToCore(bootTask, "boot", BOOT_TASK_STACK_SIZE, nullptr, 1, nullptr,
+                              xPortGetCoreID()) != pdPASS) {
+    log_e("Failed to start the boot task.");
+    runBootSteps();
+    bootStepsDone = true;
   }
-}
+  String shownText;
+  while (true) {
+    // read before the queue so that the last step is drawn
+    bool done = bootStepsDone;
+    BootProgress progress;
+    if (xQueueReceive(bootProgress, &progress, 0) == pdTRUE) {
+      if (shownText != progress.text) {
+        drawProgressText(progress.text);
+        shownText = progress.text;
+      }
+      progressBar.setTarget(progress.percentage);
+    }
+    if (!progressBar.animate() && done) break;
+    delay(PROGRESS_FRAME_MILLIS);
+  }
+  lastUpdateMillis = millis();
+#ifdef POWER_SAVING
+  stopWiFi();
+  logPowerTelemetry();
+#endif
 
-void repaint() {
-  tft.fillScreen(TFT_BLACK);
-  ui.drawLogo();
+  render(drawDashboard);
+}
 
-  ofr.setFontSize(16);
-  ofr.cdrawString(APP_NAME, centerWidth, tft.height() - 50);
-  ofr.cdrawString(VERSION, centerWidth, tft.height() - 30);
+// Posts a boot step to the loop, replacing one it hasn't drawn yet.
+void reportProgress(const char *text, uint8_t percentage) {
+  BootProgress progress;
+  strlcpy(progress.text, text, sizeof(progress.text));
+  progress.percentage = percentage;
+  xQueueOverwrite(bootProgress, &progress);
+}
 
-  drawProgress("Starting WiFi...", 10);
+// WiFi, time sync and the weather of all locations, runs in the boot task.
+void runBootSteps() {
+  reportProgress("Starting WiFi...", 10);
   if (WiFi.status() != WL_CONNECTED) {
     startWiFi();
   }
 
-  drawProgress("Synchronizing time...", 30);
-  syncTime();
+  // the response is handled in the background while the weather is fetched, the clock is slewed
+  // rather than stepped if it's already set
+  if (isTimeSyncDue()) {
+    reportProgress("Synchronizing time...", 30);
+    startTimeSync();
+  }
 
   updateData(true);
 
-  drawProgress("Ready", 100);
-  lastUpdateMillis = millis();
+  if (!isTimeSynced()) {
+    reportProgress("Synchronizing time...", 95);
+    if (waitForTimeSync(TIME_SYNC_TIMEOUT_MILLIS)) {
+      log_i("Current local time: %s", getCurrentTimestamp(SYSTEM_TIMESTAMP_FORMAT).c_str());
+    }
+  }
 
-  tft.fillScreen(TFT_BLACK);
+  reportProgress("Ready", 100);
+}
 
-  drawTimeAndDate();
-  drawSeparator(90);
+void bootTask(void *parameter) {
+  runBootSteps();
+  bootStepsDone = true;
+  vTaskDelete(nullptr);
+}
 
-  drawCurrentWeather();
-  drawSeparator(230);
+void updateData(boolean updateProgressBar) {
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    if (updateProgressBar) {
+      String text = "Updating " + getLocationName(i) + "...";
+      reportProgress(text.c_str(), 40 + 50 * i / LOCATION_COUNT);
+    }
+    updateLocation(i);
+  }
+  scheduleNextLocationUpdate(true);
+}
 
-  drawForecast();
-  drawSeparator(355);
+// Updates the location next in turn without the progress screen, redraws it if it's displayed and
+// got new weather. WiFi stays off if there's nothing due.
+void updateNextLocation() {
+  uint8_t index = nextLocationUpdate;
+  scheduleNextLocationUpdate(false);
+  bool refreshDue = isLocationRefreshDue(index);
+  if (!refreshDue && !isTimeSyncDue()) {
+    log_d("Skipping %s, no new weather expected yet.", getLocationName(index).c_str());
+    return;
+  }
 
-  drawAstro();
-}
+  if (WiFi.status() != WL_CONNECTED) {
+    startWiFi();
+  }
+  if (isTimeSyncDue()) startTimeSync();
 
-void updateData(boolean updateProgressBar) {
-  if(updateProgressBar) drawProgress("Updating weather...", 70);
-  OpenWeatherMapCurrent *currentWeatherClient = new OpenWeatherMapCurrent();
-  currentWeatherClient->setMetric(IS_METRIC);
-  currentWeatherClient->setLanguage(OPEN_WEATHER_MAP_LANGUAGE);
-  currentWeatherClient->updateCurrentById(&currentWeather, OPEN_WEATHER_MAP_API_KEY, OPEN_WEATHER_MAP_LOCATION_ID);
-  delete currentWeatherClient;
-  currentWeatherClient = nullptr;
-  log_i("Current weather in %s: %s, %.1f°", currentWeather.cityName, currentWeather.description.c_str(), currentWeather.feelsLike);
-
-  if(updateProgressBar) drawProgress("Updating forecast...", 90);
-  OpenWeatherMapForecast *forecastClient = new OpenWeatherMapForecast();
-  forecastClient->setMetric(IS_METRIC);
-  forecastClient->setLanguage(OPEN_WEATHER_MAP_LANGUAGE);
-  forecastClient->setAllowedHours(forecastHoursUtc, sizeof(forecastHoursUtc));
-  forecastClient->updateForecastsById(forecasts, OPEN_WEATHER_MAP_API_KEY, OPEN_WEATHER_MAP_LOCATION_ID, NUMBER_OF_FORECASTS);
-  delete forecastClient;
-  forecastClient = nullptr;
+  LocationUpdate update = refreshDue ? updateLocation(index) : LOCATION_UNCHANGED;
+  lastUpdateMillis = millis();
+#ifdef POWER_SAVING
+  stopWiFi();
+  logPowerTelemetry();
+#endif
+
+  if (update == LOCATION_UPDATED && index == displayedLocation) {
+    render(drawWeather);
+  }
 }
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include "settings.h"
+
+typedef struct PowerTelemetry {
+  uint64_t awakeMicros;
+  uint64_t asleepMicros;
+  uint32_t timerWakeups;
+  uint32_t touchWakeups;
+} PowerTelemetry;
+
+PowerTelemetry powerTelemetry;
+int64_t lastWakeMicros = 0;
+
+esp_timer_handle_t clockTickTimer = nullptr;
+volatile bool clockTickDue = false;
+
+void onClockTick(void *arg);
+int64_t microsUntilNextSecond();
+
+/**
+ * Starts the clock tick timer. With POWER_SAVING also prepares light sleep: the backlight PWM needs
+ * the RTC8M clock to keep running and the touch INT line becomes a wake-up source.
+ */
+void initPowerManagement() {
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onClockTick;
+  timerArgs.name = "clock-tick";
+  esp_timer_create(&timerArgs, &clockTickTimer);
+  esp_timer_start_once(clockTickTimer, microsUntilNextSecond());
+
+#ifdef POWER_SAVING
+  pinMode(TOUCH_INT, INPUT_PULLUP);
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC8M, ESP_PD_OPTION_ON);
+  lastWakeMicros = esp_timer_get_time();
+  log_i("Power saving enabled, touch INT at pin %d.", TOUCH_INT);
+#endif
+}
+
+/**
+ * @return true once per second, on the full second of the system clock
+ */
+bool takeClockTick() {
+  if (!clockTickDue) return false;
+  clockTickDue = false;
+  return true;
+}
+
+/**
+ * Enters light sleep until the next esp_timer alarm (the clock tick or any other), the touch
+ * controller asserting INT or the given deadline, whatever comes first. Returns right away if
+ * that's too close to be worth it.
+ *
+ * @param deadlineMillis millis() at which the next data refresh is due
+ */
+void sleepUntilNextEvent(unsigned long deadlineMillis) {
+  int64_t now = esp_timer_get_time();
+  int64_t sleepMicros = esp_timer_get_next_alarm() - now;
+  // signed difference survives the wrap-around of millis()
+  int64_t deadlineMicros = (int64_t)(int32_t)(deadlineMillis - millis()) * 1000;
+  sleepMicros = min(sleepMicros, deadlineMicros);
+
+  // a resting finger keeps INT low, which would wake up again immediately -> poll for the release
+  bool touchActive = digitalRead(TOUCH_INT) == LOW;
+  if (touchActive) {
+    sleepMicros = min(sleepMicros, (int64_t)POWER_TOUCH_POLL_MICROS);
+  }
+  if (sleepMicros < POWER_MIN_SLEEP_MICROS) return;
+
+  esp_sleep_enable_timer_wakeup(sleepMicros);
+  if (!touchActive) {
+    gpio_wakeup_enable((gpio_num_t)TOUCH_INT, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+  }
+  // the UART stops in light sleep, pending log output would be garbled
+  Serial.flush();
+
+  powerTelemetry.awakeMicros += now - lastWakeMicros;
+  esp_light_sleep_start();
+  lastWakeMicros = esp_timer_get_time();
+  powerTelemetry.asleepMicros += lastWakeMicros - now;
+
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+    powerTelemetry.touchWakeups++;
+  } else {
+    powerTelemetry.timerWakeups++;
+  }
+  if (!touchActive) {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    gpio_wakeup_disable((gpio_num_t)TOUCH_INT);
+  }
+}
+
+/**
+ * Logs the share of time spent awake and the average current of the ESP32 estimated from it.
+ */
+void logPowerTelemetry() {
+  uint64_t awakeMicros = powerTelemetry.awakeMicros + (esp_timer_get_time() - lastWakeMicros);
+  double total = awakeMicros + powerTelemetry.asleepMicros;
+  if (total == 0) return;
+  double awakeShare = awakeMicros / total;
+  log_i("Power: awake %.1f%% of %.0fs, ~%.1f mA average, %u timer & %u touch wake-ups.",
+        awakeShare * 100, total / 1000000, awakeShare * POWER_AWAKE_CURRENT_MA +
+        (1 - awakeShare) * POWER_LIGHT_SLEEP_CURRENT_MA, powerTelemetry.timerWakeups,
+        powerTelemetry.touchWakeups);
+}
+
+int64_t microsUntilNextSecond() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return 1000000 - now.tv_usec;
+}
+
+// Re-armed for every tick rather than periodic so the ticks stay on the full second even when the
+// system clock gets adjusted.
+void onClockTick(void *arg) {
+  clockTickDue = true;
+  esp_timer_start_once(clockTickTimer, microsUntilNextSecond());
+}
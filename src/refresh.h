@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "WeatherSnapshot.h"
+#include "backlight.h"
+#include "config.h"
+#include "settings.h"
+
+#define REFRESH_DAY_MILLIS (24 * 3600 * 1000UL)
+// the interval scale stays at its minimum while the weather is volatile, and grows by a step per
+// stable pressure window up to the maximum
+#define REFRESH_VOLATILE_SCALE 0.5f
+#define REFRESH_STABLE_SCALE_STEP 0.25f
+#define REFRESH_STABLE_SCALE_MAX 2.0f
+
+// Pressure and condition of the observations of a location, judged once per pressure window.
+typedef struct WeatherTrend {
+  uint32_t pressureTime;
+  uint16_t pressure;
+  bool isVolatile;
+  // pressure windows without a fast change since the weather was last volatile
+  uint8_t stableWindows;
+} WeatherTrend;
+
+// Requests made within the current day, the day starts with the first request after the last one.
+typedef struct ApiBudget {
+  unsigned long dayStartMillis;
+  uint16_t calls;
+} ApiBudget;
+
+WeatherTrend weatherTrends[LOCATION_COUNT];
+ApiBudget apiBudget = {0, 0};
+// the decision last logged
+uint32_t loggedRefreshMinutes = 0;
+
+float getTrendScale(const WeatherTrend *trend) {
+  if (trend->isVolatile) return REFRESH_VOLATILE_SCALE;
+  return min(1.0f + trend->stableWindows * REFRESH_STABLE_SCALE_STEP, REFRESH_STABLE_SCALE_MAX);
+}
+
+/**
+ * Judges a new observation of the location against the previous one. The condition group
+ * (thunderstorm, rain, clouds, ...) changing makes the weather volatile right away. Pressure is
+ * compared at most once per REFRESH_PRESSURE_WINDOW_MINUTES since whole hPa are too coarse for
+ * anything shorter.
+ */
+void recordObservation(uint8_t index, const char *name, const CurrentRecord *previous,
+                       const CurrentRecord *latest) {
+  WeatherTrend *trend = &weatherTrends[index];
+  if (trend->pressureTime == 0 || latest->observationTime < trend->pressureTime) {
+    trend->pressureTime = latest->observationTime;
+    trend->pressure = latest->pressure;
+  }
+  if (previous->observationTime != 0 && previous->condition != WEATHER_SNAPSHOT_NONE &&
+      conditionCode(previous->condition) / 100 != conditionCode(latest->condition) / 100) {
+    log_i("Weather in %s turned volatile: condition %d -> %d.", name,
+          conditionCode(previous->condition), conditionCode(latest->condition));
+    trend->isVolatile = true;
+    trend->stableWindows = 0;
+  }
+  if (latest->observationTime - trend->pressureTime < REFRESH_PRESSURE_WINDOW_MINUTES * 60UL) {
+    return;
+  }
+
+  int32_t change = (int32_t)latest->pressure - trend->pressure;
+  bool wasVolatile = trend->isVolatile;
+  trend->isVolatile = abs(change) >= REFRESH_VOLATILE_PRESSURE_HPA;
+  if (trend->isVolatile) {
+    trend->stableWindows = 0;
+  } else if (getTrendScale(trend) < REFRESH_STABLE_SCALE_MAX) {
+    trend->stableWindows++;
+  }
+  if (trend->isVolatile != wasVolatile) {
+    log_i("Weather in %s turned %s: pressure %+d hPa in %d min.", name,
+          trend->isVolatile ? "volatile" : "stable", change,
+          (latest->observationTime - trend->pressureTime) / 60);
+  }
+  trend->pressureTime = latest->observationTime;
+  trend->pressure = latest->pressure;
+}
+
+// the budget day rolls over 24h after its first request
+void rollApiBudgetDay() {
+  if (apiBudget.calls > 0 && millis() - apiBudget.dayStartMillis >= REFRESH_DAY_MILLIS) {
+    log_i("%d OpenWeatherMap requests in the last 24h.", apiBudget.calls);
+    apiBudget.calls = 0;
+  }
+}
+
+void countApiCalls(uint8_t calls) {
+  rollApiBudgetDay();
+  if (apiBudget.calls == 0) apiBudget.dayStartMillis = millis();
+  apiBudget.calls += calls;
+}
+
+/**
+ * The shortest interval that lets the rest of the day's budget last until the day rolls over, if
+ * every location needs both of its requests in every round.
+ */
+uint32_t getBudgetIntervalMillis() {
+  rollApiBudgetDay();
+  if (apiBudget.calls == 0) return 0;
+  uint32_t callsPerRound = 2 * LOCATION_COUNT;
+  uint32_t left = apiBudget.calls < OPEN_WEATHER_MAP_CALLS_PER_DAY
+                      ? OPEN_WEATHER_MAP_CALLS_PER_DAY - apiBudget.calls
+                      : 0;
+  uint32_t restOfDayMillis = REFRESH_DAY_MILLIS - (millis() - apiBudget.dayStartMillis);
+  uint32_t rounds = left / callsPerRound;
+  return rounds == 0 ? restOfDayMillis : restOfDayMillis / rounds;
+}
+
+/**
+ * The interval each location is updated in: the configured one scaled down while the weather
+ * of any location is volatile, up while all of it is stable and while the display is dimmed or
+ * off, then stretched to stay within OPEN_WEATHER_MAP_CALLS_PER_DAY. Changes of the decision are
+ * logged.
+ */
+uint32_t getRefreshIntervalMillis() {
+  float weatherScale = REFRESH_STABLE_SCALE_MAX;
+  for (uint8_t i = 0; i < LOCATION_COUNT; i++) {
+    weatherScale = min(weatherScale, getTrendScale(&weatherTrends[i]));
+  }
+  float presenceScale = !isBacklightOn()      ? REFRESH_OFF_FACTOR
+                        : isBacklightDimmed() ? REFRESH_DIMMED_FACTOR
+                                              : 1.0f;
+  float minutes = constrain(config.updateIntervalMinutes * weatherScale * presenceScale,
+                            (float)REFRESH_MIN_INTERVAL_MINUTES,
+                            (float)REFRESH_MAX_INTERVAL_MINUTES);
+  uint32_t intervalMillis = minutes * 60 * 1000;
+  uint32_t budgetMillis = getBudgetIntervalMillis();
+  bool overBudget = budgetMillis > intervalMillis;
+  if (overBudget) intervalMillis = budgetMillis;
+
+  uint32_t intervalMinutes = (intervalMillis + 30000) / 60000;
+  if (intervalMinutes != loggedRefreshMinutes) {
+    log_i("Refresh interval %d -> %d min: weather x%.2f, display x%.0f%s, %d/%d requests today.",
+          loggedRefreshMinutes, intervalMinutes, weatherScale, presenceScale,
+          overBudget ? ", held back by the API budget" : "", apiBudget.calls,
+          OPEN_WEATHER_MAP_CALLS_PER_DAY);
+    loggedRefreshMinutes = intervalMinutes;
+  }
+  return intervalMillis;
+}
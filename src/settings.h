@@ -6,6 +6,9 @@
 // ****************************************************************************
 // User settings
 // ****************************************************************************
+// WiFi, OpenWeatherMap, locations, units, timezone and update interval are only the defaults: they
+// can be changed at runtime on the serial console and are kept in NVS from then on, see config.h
+
 // WiFi
 const char *SSID = "yourssid";
 const char *WIFI_PWD = "yourpassw0rd";
@@ -13,11 +16,26 @@ const char *WIFI_PWD = "yourpassw0rd";
 // timezone Europe/Zurich as per https://github.com/nayarsystems/posix_tz_db/blob/master/zones.csv
 #define TIMEZONE "CET-1CEST,M3.5.0,M10.5.0/3"
 
+// for steady weather while the display is lit, see REFRESH_xyz below for how it adapts
 #define UPDATE_INTERVAL_MINUTES 10
+// OpenWeatherMap requests per day, updates are spaced out further once they'd use up more
+#define OPEN_WEATHER_MAP_CALLS_PER_DAY 500
 
 // uncomment to get "08/23/2022 02:55:02 pm" instead of "23.08.2022 14:55:02"
 // #define DATE_TIME_FORMAT_US
 
+// uncomment to sleep between clock ticks and switch WiFi off between weather updates, for battery
+// powered units
+// #define POWER_SAVING
+
+// the backlight is dimmed after this many seconds without touching the screen
+#define BACKLIGHT_DIM_AFTER_SECONDS 300
+// uncomment to switch the display off at night, either between these hours (local time)...
+// #define BACKLIGHT_OFF_FROM_HOUR 23
+// #define BACKLIGHT_OFF_UNTIL_HOUR 6
+// ...or between sunset and sunrise, a touch switches it on again for BACKLIGHT_DIM_AFTER_SECONDS
+// #define BACKLIGHT_OFF_BETWEEN_SUNSET_AND_SUNRISE
+
 // values in metric or imperial system?
 bool IS_METRIC = true;
 
@@ -29,16 +47,20 @@ const String OPEN_WEATHER_MAP_API_KEY = "";
 Go to https://openweathermap.org/find?q= and search for a location. Go through the
 result set and select the entry closest to the actual location you want to display
 data for. It'll be a URL like https://openweathermap.org/city/2657896. The number
-at the end is what you assign to the constant below.
+at the end is the location ID.
+
+Each location is updated once per update interval, the updates are spread evenly across
+the interval. Updates are skipped while OpenWeatherMap isn't expected to have new data
+yet. The first one is shown after a boot, tapping the current weather switches to the
+next one. Sun and moon times are shown in the timezone for all of them.
  */
-const String OPEN_WEATHER_MAP_LOCATION_ID = "2657896";
-const String DISPLAYED_LOCATION_NAME = "Zurich";
-//String OPEN_WEATHER_MAP_LOCATION_ID = "3833367";
-//String DISPLAYED_LOCATION_NAME = "Ushuaia";
-//String OPEN_WEATHER_MAP_LOCATION_ID = "2147714";
-//String DISPLAYED_LOCATION_NAME = "Sydney";
-//String OPEN_WEATHER_MAP_LOCATION_ID = "5879400";
-//String DISPLAYED_LOCATION_NAME = "Anchorage";
+const char *OPEN_WEATHER_MAP_LOCATIONS[][2] = {
+  // {location ID, displayed name}
+  {"2657896", "Zurich"},
+  // {"3833367", "Ushuaia"},
+  // {"2147714", "Sydney"},
+  // {"5879400", "Anchorage"},
+};
 
 // Supported languages: https://openweathermap.org/current#multi
 const String OPEN_WEATHER_MAP_LANGUAGE = "en";
@@ -62,6 +84,12 @@ typedef struct RectangleDef {
   uint16_t height;
 } RectangleDef;
 
+// a step of the boot sequence, handed from the boot task to the loop which draws it
+typedef struct BootProgress {
+  char text[40];
+  uint8_t percentage;
+} BootProgress;
+
 typedef struct DayForecast {
   float minTemp;
   float maxTemp;
@@ -70,13 +98,34 @@ typedef struct DayForecast {
   int day;
 } DayForecast;
 
-RectangleDef timeSpritePos = {0, 0, 320, 88};
+// all images on the flash FS, packed by scripts/pack_assets.py
+#define ASSET_ARCHIVE "/assets.pak"
+// same archive with pre-converted images, memory-mapped from this partition (-D ASSETS_PARTITION)
+#define ASSET_PARTITION "assets"
 
 const String WIND_ICON_NAMES[] = {"N", "NE", "E", "SE", "S", "SW", "W", "NW"};
 
+#define LOCATION_COUNT (sizeof(OPEN_WEATHER_MAP_LOCATIONS) / sizeof(OPEN_WEATHER_MAP_LOCATIONS[0]))
+// The update interval is halved while the weather of any location is volatile: the condition
+// group changed (e.g. clouds to rain) or the pressure changed by REFRESH_VOLATILE_PRESSURE_HPA
+// within REFRESH_PRESSURE_WINDOW_MINUTES. Each stable window stretches it by a quarter up to
+// double. It's stretched by these factors while the display is dimmed or off, then limited to the
+// bounds.
+#define REFRESH_PRESSURE_WINDOW_MINUTES 60
+#define REFRESH_VOLATILE_PRESSURE_HPA 2
+#define REFRESH_DIMMED_FACTOR 2
+#define REFRESH_OFF_FACTOR 4
+#define REFRESH_MIN_INTERVAL_MINUTES 5
+#define REFRESH_MAX_INTERVAL_MINUTES 120
+// a location is skipped while max-age or the observed update cadence of OpenWeatherMap say there's
+// nothing new, but it's requested again after this long at the latest
+#define WEATHER_MAX_REFRESH_MINUTES 60
+
 // average approximation for the actual length of the synodic month
 const double LUNAR_MONTH = 29.530588853;
 const uint8_t NUMBER_OF_MOON_IMAGES = 32;
+// sun & moon data is calculated in batches for this many days
+#define NUMBER_OF_ASTRO_DAYS 7
 
 // 2: portrait, on/off switch right side -> 0/0 top left
 // 3: landscape, on/off switch at the top -> 0/0 top left
@@ -89,21 +138,58 @@ const uint8_t NUMBER_OF_MOON_IMAGES = 32;
 #define TOUCH_SENSITIVITY 40
 #define TOUCH_SDA 23
 #define TOUCH_SCL 22
-// Initial LCD Backlight brightness
+// the touch controller pulls this low while touched, wakes from light sleep (POWER_SAVING)
+#define TOUCH_INT 27
+// LCD backlight brightness while in use and after BACKLIGHT_DIM_AFTER_SECONDS of inactivity
 #define TFT_LED_BRIGHTNESS 200
+#define TFT_LED_DIMMED_BRIGHTNESS 40
+// duration of any brightness change and the interval of its steps
+#define BACKLIGHT_FADE_MILLIS 500
+#define BACKLIGHT_FADE_STEP_MILLIS 20
+
+// Typical currents of the ESP32 & PSRAM (not the display) awake with WiFi off and in light sleep.
+// The power telemetry estimates the average current from the time spent in each.
+#define POWER_AWAKE_CURRENT_MA 45.0
+#define POWER_LIGHT_SLEEP_CURRENT_MA 1.0
+// sleeping any shorter isn't worth the wake-up overhead
+#define POWER_MIN_SLEEP_MICROS 2000
+// polling interval while the finger rests on the screen (INT stays low)
+#define POWER_TOUCH_POLL_MICROS 50000
+
+// calibrate the SPI write clock once (persisted), SPI_FREQUENCY in platformio.ini is the fallback
+#define SPI_CLOCK_AUTOTUNE
+
+// the display transfers run on this core, the other one than the Arduino loop
+#define BLIT_TASK_CORE 0
+// WiFi, time sync and the first weather updates run in a task of this stack size while the loop
+// animates the progress bar every PROGRESS_FRAME_MILLIS
+#define BOOT_TASK_STACK_SIZE 8192
+#define PROGRESS_FRAME_MILLIS 20
+// height of the band the boot step is written to, above the progress bar
+#define PROGRESS_TEXT_HEIGHT 40
+
+// SNTP resyncs about when the clock is expected to be TIME_SYNC_MAX_ERROR_MILLIS off, based on the
+// drift measured between syncs, but within these bounds
+#define NTP_SERVER "pool.ntp.org"
+#define TIME_SYNC_MIN_INTERVAL_HOURS 1
+#define TIME_SYNC_MAX_INTERVAL_HOURS 24
+#define TIME_SYNC_MAX_ERROR_MILLIS 250
+// how long the first sync after a boot may take before the screen is drawn anyway
+#define TIME_SYNC_TIMEOUT_MILLIS 10000
 
 // the medium blue in the TP logo is 0x0067B0 which converts to 0x0336 in 16bit RGB565
 #define TFT_TP_BLUE 0x0336
 
 // format specifiers: https://cplusplus.com/reference/ctime/strftime/
 #ifdef DATE_TIME_FORMAT_US
-  int timePosX = 29;
+  // width of the time string at font size 48, it's placed manually rather than centered
+  #define UI_TIME_WIDTH 262
   #define UI_DATE_FORMAT "%m/%d/%Y"
   #define UI_TIME_FORMAT "%H:%M:%S %P"
   #define UI_TIME_FORMAT_NO_SECONDS "%I:%M %P"
   #define UI_TIMESTAMP_FORMAT (UI_DATE_FORMAT + " " + UI_TIME_FORMAT)
 #else
-  int timePosX = 68;
+  #define UI_TIME_WIDTH 184
   #define UI_DATE_FORMAT "%d.%m.%Y"
   #define UI_TIME_FORMAT "%H:%M:%S"
   #define UI_TIME_FORMAT_NO_SECONDS "%H:%M"
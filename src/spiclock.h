@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <LittleFS.h>
+#include <SPI.h>
+#include <TFT_eSPI.h>
+
+#include "settings.h"
+
+#define SPI_CLOCK_FILE "/spi-clock.bin"
+// bump whenever the layout of SpiClockCalibration or the candidates change
+#define SPI_CLOCK_VERSION 2
+// size of the test pattern, drawn to the top left corner before anything else is on the display
+#define SPI_CLOCK_TEST_SIZE 32
+#define SPI_CLOCK_TEST_PATTERNS 3
+
+// The ESP32's SPI timing is only specified up to 40MHz through the GPIO matrix, 80MHz needs the
+// IOMUX pins of the port (SCLK/MOSI 18/23 for VSPI, 14/13 for HSPI). A single read-back can't
+// prove a clock outside the specification stable.
+#ifdef USE_HSPI_PORT
+#define SPI_CLOCK_IOMUX_PINS (TFT_SCLK == 14 && TFT_MOSI == 13)
+#else
+#define SPI_CLOCK_IOMUX_PINS (TFT_SCLK == 18 && TFT_MOSI == 23)
+#endif
+
+// write clocks tried in ascending order on top of SPI_FREQUENCY, the ESP32 divides them from 80MHz
+#if SPI_CLOCK_IOMUX_PINS
+const uint32_t SPI_CLOCK_CANDIDATES[] = {40000000, 80000000};
+#else
+const uint32_t SPI_CLOCK_CANDIDATES[] = {40000000};
+#endif
+
+typedef enum SpiClockState {
+  SPI_CLOCK_CALIBRATED = 1,
+  // set while a candidate is tested, finding it after a restart means the candidate hung the device
+  SPI_CLOCK_TESTING = 2
+} SpiClockState;
+
+typedef struct SpiClockCalibration {
+  uint16_t version;
+  uint8_t state;
+  // SPI_FREQUENCY at the time of the calibration, a different one triggers a new calibration
+  uint32_t baseFrequency;
+  // highest frequency that passed
+  uint32_t frequency;
+  uint32_t testedFrequency;
+} SpiClockCalibration;
+
+// write clock for bulk pixel transfers, see startTunedWrite()
+uint32_t spiWriteFrequency = SPI_FREQUENCY;
+
+void calibrateSpiClock(TFT_eSPI *tft, SpiClockCalibration *calibration);
+void fillTestPattern(uint16_t *pixels, uint8_t pattern);
+bool loadSpiClockCalibration(SpiClockCalibration *calibration);
+void saveSpiClockCalibration(const SpiClockCalibration *calibration);
+bool testSpiClock(TFT_eSPI *tft, uint32_t frequency);
+
+/**
+ * Applies the persisted SPI write clock or calibrates one: the clock is stepped up through
+ * SPI_CLOCK_CANDIDATES as long as test patterns written at that clock read back correctly (at
+ * SPI_READ_FREQUENCY). SPI_FREQUENCY from platformio.ini remains the fallback whenever the panel
+ * can't be read back or anything goes wrong. Must run before anything is drawn.
+ */
+void initSpiClock(TFT_eSPI *tft) {
+#ifdef SPI_CLOCK_AUTOTUNE
+  SpiClockCalibration calibration;
+  bool loaded = loadSpiClockCalibration(&calibration);
+  if (loaded && calibration.state == SPI_CLOCK_TESTING) {
+    log_w("SPI clock test at %u Hz didn't finish, keeping %u Hz.", calibration.testedFrequency,
+          calibration.frequency);
+    calibration.state = SPI_CLOCK_CALIBRATED;
+    saveSpiClockCalibration(&calibration);
+  } else if (!loaded || calibration.state != SPI_CLOCK_CALIBRATED) {
+    calibrateSpiClock(tft, &calibration);
+  }
+  spiWriteFrequency = calibration.frequency;
+  log_i("SPI write clock: %u Hz (fallback %u Hz).", spiWriteFrequency, SPI_FREQUENCY);
+#endif
+}
+
+/**
+ * startWrite() at the calibrated clock, TFT_eSPI itself uses the compile time SPI_FREQUENCY for
+ * every transaction. Bulk transfers should be wrapped in this and endWrite().
+ */
+void startTunedWrite(TFT_eSPI *tft) {
+  tft->startWrite();
+  if (spiWriteFrequency != SPI_FREQUENCY) tft->getSPIinstance().setFrequency(spiWriteFrequency);
+}
+
+void calibrateSpiClock(TFT_eSPI *tft, SpiClockCalibration *calibration) {
+  calibration->version = SPI_CLOCK_VERSION;
+  calibration->baseFrequency = SPI_FREQUENCY;
+  calibration->frequency = SPI_FREQUENCY;
+  calibration->testedFrequency = 0;
+
+  // read-back at the safe clock needs to work for the test to mean anything
+  if (!testSpiClock(tft, SPI_FREQUENCY)) {
+    log_w("Display read-back doesn't work, SPI clock stays at %u Hz.", SPI_FREQUENCY);
+  } else {
+    for (uint8_t i = 0; i < sizeof(SPI_CLOCK_CANDIDATES) / sizeof(SPI_CLOCK_CANDIDATES[0]); i++) {
+      uint32_t frequency = SPI_CLOCK_CANDIDATES[i];
+      if (frequency <= SPI_FREQUENCY) continue;
+
+      calibration->state = SPI_CLOCK_TESTING;
+      calibration->testedFrequency = frequency;
+      saveSpiClockCalibration(calibration);
+      if (!testSpiClock(tft, frequency)) break;
+      calibration->frequency = frequency;
+    }
+  }
+  calibration->state = SPI_CLOCK_CALIBRATED;
+  saveSpiClockCalibration(calibration);
+  tft->fillRect(0, 0, SPI_CLOCK_TEST_SIZE, SPI_CLOCK_TEST_SIZE, TFT_BLACK);
+}
+
+// Patterns that toggle the data line as often as possible, random data and walking bits.
+void fillTestPattern(uint16_t *pixels, uint8_t pattern) {
+  uint32_t random = 0x2545F491;
+  for (uint16_t i = 0; i < SPI_CLOCK_TEST_SIZE * SPI_CLOCK_TEST_SIZE; i++) {
+    if (pattern == 0) {
+      pixels[i] = ((i + i / SPI_CLOCK_TEST_SIZE) & 1) ? 0xFFFF : 0x0000;
+    } else if (pattern == 1) {
+      // xorshift32
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      pixels[i] = (uint16_t)random;
+    } else {
+      pixels[i] = 1 << (i % 16);
+    }
+  }
+}
+
+bool loadSpiClockCalibration(SpiClockCalibration *calibration) {
+  if (!LittleFS.exists(SPI_CLOCK_FILE)) return false;
+
+  File file = LittleFS.open(SPI_CLOCK_FILE, "r");
+  bool valid = file.read((uint8_t *)calibration, sizeof(SpiClockCalibration)) ==
+                   sizeof(SpiClockCalibration) &&
+               calibration->version == SPI_CLOCK_VERSION &&
+               calibration->baseFrequency == SPI_FREQUENCY;
+  file.close();
+  return valid;
+}
+
+void saveSpiClockCalibration(const SpiClockCalibration *calibration) {
+  File file = LittleFS.open(SPI_CLOCK_FILE, "w");
+  if (!file || file.write((uint8_t *)calibration, sizeof(SpiClockCalibration)) !=
+                   sizeof(SpiClockCalibration)) {
+    log_e("Failed to persist SPI clock calibration.");
+  }
+  file.close();
+}
+
+/**
+ * Writes the test patterns at the given clock and compares what reads back.
+ */
+bool testSpiClock(TFT_eSPI *tft, uint32_t frequency) {
+  static uint16_t written[SPI_CLOCK_TEST_SIZE * SPI_CLOCK_TEST_SIZE];
+  static uint16_t read[SPI_CLOCK_TEST_SIZE * SPI_CLOCK_TEST_SIZE];
+
+  bool oldSwap = tft->getSwapBytes();
+  tft->setSwapBytes(false);
+  bool passed = true;
+  for (uint8_t pattern = 0; pattern < SPI_CLOCK_TEST_PATTERNS && passed; pattern++) {
+    fillTestPattern(written, pattern);
+    tft->startWrite();
+    tft->getSPIinstance().setFrequency(frequency);
+    tft->pushImage(0, 0, SPI_CLOCK_TEST_SIZE, SPI_CLOCK_TEST_SIZE, written);
+    tft->endWrite();
+
+    tft->readRect(0, 0, SPI_CLOCK_TEST_SIZE, SPI_CLOCK_TEST_SIZE, read);
+    passed = memcmp(written, read, sizeof(written)) == 0;
+  }
+  tft->setSwapBytes(oldSwap);
+  log_i("SPI clock test at %u Hz: %s", frequency, passed ? "passed" : "failed");
+  return passed;
+}
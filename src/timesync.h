@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2023 ThingPulse Ltd., https://thingpulse.com
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <esp_sntp.h>
+#include <sys/time.h>
+
+#include "settings.h"
+
+typedef struct TimeSyncState {
+  bool synced;
+  uint32_t syncCount;
+  // server time of the last sync
+  int64_t lastSyncMicros;
+  // system clock minus server time at the last sync, before the correction
+  int32_t lastOffsetMillis;
+  // drift of the system clock measured between the last two syncs, positive if it runs fast
+  float driftPpm;
+  uint32_t intervalMillis;
+  unsigned long nextSyncMillis;
+} TimeSyncState;
+
+volatile TimeSyncState timeSync = {};
+
+void onTimeSync(struct timeval *serverTime);
+
+/**
+ * Configures SNTP without starting it. Corrections of less than 35 minutes are slewed with
+ * adjtime() by the SNTP client (smooth mode): the clock runs slightly faster or slower until
+ * it's back in line, so the displayed seconds never jump or repeat. Only the very first sync steps
+ * the clock.
+ */
+void initTimeSync() {
+  sntp_setoperatingmode(SNTP_OPMODE_POLL);
+  sntp_setservername(0, NTP_SERVER);
+  sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+  sntp_set_time_sync_notification_cb(onTimeSync);
+  timeSync.intervalMillis = TIME_SYNC_MIN_INTERVAL_HOURS * 3600000UL;
+}
+
+bool isTimeSynced() {
+  return timeSync.synced;
+}
+
+bool isTimeSyncDue() {
+  return !timeSync.synced || (long)(millis() - timeSync.nextSyncMillis) >= 0;
+}
+
+/**
+ * Sends an SNTP request and returns right away, onTimeSync() handles the response. Needs WiFi
+ * until the response arrived.
+ */
+void startTimeSync() {
+  log_i("Synchronizing time with %s.", NTP_SERVER);
+  // the client polls on its own as well, as long as WiFi is up
+  sntp_set_sync_interval(timeSync.intervalMillis);
+  if (sntp_enabled()) {
+    sntp_restart();
+  } else {
+    sntp_init();
+  }
+}
+
+/**
+ * Blocks until the clock got synchronized once, e.g. before anything date related is drawn after
+ * a boot.
+ *
+ * @return false on timeout
+ */
+bool waitForTimeSync(unsigned long timeoutMillis) {
+  unsigned long startMillis = millis();
+  while (!timeSync.synced) {
+    if (millis() - startMillis > timeoutMillis) {
+      log_e("Failed to obtain time.");
+      return false;
+    }
+    delay(100);
+  }
+  return true;
+}
+
+// Called by the SNTP client (in the TCP/IP task) after it stepped the clock or started slewing it.
+void onTimeSync(struct timeval *serverTime) {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  int64_t serverMicros = (int64_t)serverTime->tv_sec * 1000000 + serverTime->tv_usec;
+  int64_t nowMicros = (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+  // zero after a step, the offset that's being slewed away otherwise
+  int32_t offsetMillis = (nowMicros - serverMicros) / 1000;
+
+  if (timeSync.synced) {
+    float elapsedSeconds = (serverMicros - timeSync.lastSyncMicros) / 1e6;
+    if (elapsedSeconds > 0) timeSync.driftPpm = offsetMillis * 1e3 / elapsedSeconds;
+    // sync about when the clock will be TIME_SYNC_MAX_ERROR_MILLIS off
+    float seconds = TIME_SYNC_MAX_ERROR_MILLIS * 1e3 / max(fabsf(timeSync.driftPpm), 1.0f);
+    seconds = constrain(seconds, TIME_SYNC_MIN_INTERVAL_HOURS * 3600.0f,
+                        TIME_SYNC_MAX_INTERVAL_HOURS * 3600.0f);
+    timeSync.intervalMillis = seconds * 1000;
+  }
+  timeSync.lastOffsetMillis = offsetMillis;
+  timeSync.lastSyncMicros = serverMicros;
+  timeSync.syncCount++;
+  timeSync.nextSyncMillis = millis() + timeSync.intervalMillis;
+  timeSync.synced = true;
+
+  log_i("Time synchronized (#%u): offset %d ms, drift %.1f ppm, next sync in %u min.",
+        timeSync.syncCount, offsetMillis, timeSync.driftPpm, timeSync.intervalMillis / 60000);
+}
@@ -4,9 +4,13 @@
 #pragma once
 
 #include "time.h"
+#include "WeatherSnapshot.h"
+#include "localclock.h"
 #include "settings.h"
 
-char timestampBuffer[26];
+// room for SYSTEM_TIMESTAMP_FORMAT, callers keep the buffer on their own stack as any task may
+// format a timestamp
+#define TIMESTAMP_LENGTH 26
 
 uint8_t getCurrentWeekday();
 
@@ -18,10 +22,10 @@ uint8_t getCurrentWeekday();
  * - find min/max temp for each day by comparing the temp from the current 3h forecast against the min/max found so far
  * - use the condition code (i.e. the weather) of the one 3h forecast closest to 12 moon
  *
- * @param forecasts NUMBER_OF_DAY_FORECASTS 3h/5d OWM forecast containers
+ * @param weather snapshot with the 3h/5d OWM forecasts
  * @return DayForecast* array of NUMBER_OF_DAY_FORECASTS minimal daily forecast containers
  */
-DayForecast* calculateDayForecasts(OpenWeatherMapForecastData *forecasts) {
+DayForecast* calculateDayForecasts(const WeatherSnapshot *weather) {
   uint8_t weekday = getCurrentWeekday();
   static DayForecast dayForecasts[NUMBER_OF_DAY_FORECASTS];
   for (int i = 0; i < NUMBER_OF_DAY_FORECASTS; i++) {
@@ -30,28 +34,32 @@ DayForecast* calculateDayForecasts(OpenWeatherMapForecastData *forecasts) {
   int k = -1;
   int currentForecastDay = -1;
 
-  for (uint8_t i = 0; i < NUMBER_OF_FORECASTS; i++) {
-    OpenWeatherMapForecastData forecast = forecasts[i];
-    time_t forecastTimeUtc = forecast.observationTime;
-    struct tm *forecastLocalTime = localtime(&forecastTimeUtc);
+  for (uint8_t i = 0; i < weather->forecastCount; i++) {
+    const ForecastRecord &forecast = weather->forecasts[i];
+    float temp = fromHundredths(forecast.temp);
+    struct tm forecastTime;
+    struct tm *forecastLocalTime = toLocalTime(forecast.observationTime, &forecastTime);
 
     if (weekday == forecastLocalTime->tm_wday) {
-      strftime(timestampBuffer, sizeof(timestampBuffer), SYSTEM_TIMESTAMP_FORMAT, forecastLocalTime);
-      log_d("Skipping forecast for today %s", timestampBuffer);
+      char timestamp[TIMESTAMP_LENGTH];
+      strftime(timestamp, sizeof(timestamp), SYSTEM_TIMESTAMP_FORMAT, forecastLocalTime);
+      log_d("Skipping forecast for today %s", timestamp);
       continue;
     }
 
     if (forecastLocalTime->tm_wday != currentForecastDay) {
+      // the last forecasts may reach into a fifth day
+      if (k == NUMBER_OF_DAY_FORECASTS - 1) break;
       currentForecastDay = forecastLocalTime->tm_wday;
       k++;
       dayForecasts[k].day = currentForecastDay;
     }
-    log_d("Current forecast day: %d, array index: %d, hour: %d, temp: %.1f", currentForecastDay, k, forecastLocalTime->tm_hour, forecast.temp);
-    if (forecast.temp < dayForecasts[k].minTemp) dayForecasts[k].minTemp = forecast.temp;
-    if (forecast.temp > dayForecasts[k].maxTemp) dayForecasts[k].maxTemp = forecast.temp;
+    log_d("Current forecast day: %d, array index: %d, hour: %d, temp: %.1f", currentForecastDay, k, forecastLocalTime->tm_hour, temp);
+    if (temp < dayForecasts[k].minTemp) dayForecasts[k].minTemp = temp;
+    if (temp > dayForecasts[k].maxTemp) dayForecasts[k].maxTemp = temp;
     // find the condition closest to 12 noon (tm_hour is 0-23)
     if (abs(12 - forecastLocalTime->tm_hour) < abs(12 - dayForecasts[k].conditionHour)) {
-      dayForecasts[k].conditionCode = forecast.weatherId;
+      dayForecasts[k].conditionCode = conditionCode(forecast.condition);
       dayForecasts[k].conditionHour = forecastLocalTime->tm_hour;
     }
   }
@@ -60,7 +68,7 @@ DayForecast* calculateDayForecasts(OpenWeatherMapForecastData *forecasts) {
 
 uint8_t getCurrentWeekday() {
   struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
+  if (!getLocalNow(&timeinfo)) {
     log_e("Failed to obtain time.");
     return -1;
   }
@@ -69,26 +77,13 @@ uint8_t getCurrentWeekday() {
 
 String getCurrentTimestamp(const char* format) {
   struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
+  if (!getLocalNow(&timeinfo)) {
     log_e("Failed to obtain time.");
     return "";
   }
-  strftime(timestampBuffer, sizeof(timestampBuffer), format, &timeinfo);
-  return String(timestampBuffer);
-}
-
-boolean initTime() {
-  struct tm timeinfo;
-
-  log_i("Synchronizing time.");
-  // Connect to NTP server with 0 TZ offset, call setTimezone() later
-  configTime(0, 0, "pool.ntp.org");
-  if (!getLocalTime(&timeinfo)) {
-    log_e("Failed to obtain time.");
-    return false;
-  }
-  log_i("UTC time: %s", getCurrentTimestamp(SYSTEM_TIMESTAMP_FORMAT).c_str());
-  return true;
+  char timestamp[TIMESTAMP_LENGTH];
+  strftime(timestamp, sizeof(timestamp), format, &timeinfo);
+  return String(timestamp);
 }
 
 void logBanner() {
@@ -104,13 +99,6 @@ void logMemoryStats() {
   log_i("Free PSRAM: %d", ESP.getFreePsram());
 }
 
-void setTimezone(const char* timezone) {
-  log_i("Setting timezone to '%s'.", timezone);
-  // Clock settings are adjusted to show the new local time
-  setenv("TZ", timezone, 1);
-  tzset();
-}
-
 // Algorithm: http://howardhinnant.github.io/date_algorithms.html
 int days_from_epoch(int y, int m, int d) {
   y -= m <= 2;